@@ -25,6 +25,13 @@ void pin_to_core(int core_id) {
     sched_setaffinity(0, sizeof(cpu_set_t), &cpuset);
 }
 
+void unpin_all_cores() {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (int i = 0; i < CPU_SETSIZE; ++i) CPU_SET(i, &cpuset);
+    sched_setaffinity(0, sizeof(cpu_set_t), &cpuset);
+}
+
 std::string read_file(const std::string& path) {
     std::ifstream f(path, std::ios::binary | std::ios::ate);
     if (!f) return "";
@@ -66,6 +73,12 @@ int main() {
         {"Huge (256MB)", huge_data.data(), huge_data.size() - 128}
     };
 
+    // Opcjonalnie: plik > 4 GiB (generate_data_new --large) - offsety 64-bitowe
+    std::string large_data = read_file("huge_4g.json");
+    if (!large_data.empty()) {
+        jobs.push_back({"Huge (4.5GB)", large_data.data(), large_data.size() - 128});
+    }
+
     std::cout << "==========================================================" << std::endl;
     std::cout << "[PROTOKÓŁ: ZERO BIAS - ULTRA PRECISION TEST]" << std::endl;
     std::cout << "[ISA: " << Tachyon::get_isa_name() << " | ITERS: 50 | WARMUP: 20]" << std::endl;
@@ -81,7 +94,7 @@ int main() {
         std::cout << "|---|---|---|" << std::endl;
 
         // --- 1. SIMDJSON (IDZIE PIERWSZY) ---
-        {
+        if (job.size < 0xFFFFFFFFull) { // simdjson: limit 4 GiB
             simdjson::ondemand::parser parser;
             simdjson::padded_string_view p_view(job.ptr, job.size, job.size + 64);
             std::vector<double> times;
@@ -111,7 +124,7 @@ int main() {
 
         // --- 2. TACHYON (IDZIE DRUGI) ---
         {
-            Tachyon::Context ctx;
+            Tachyon::BasicContext<Tachyon::Mode::Turbo> ctx;
             std::vector<double> times;
 
             // Rozgrzewka Cache
@@ -135,8 +148,56 @@ int main() {
                       << " | " << std::setprecision(12) << s.median_time << " |" << std::endl;
         }
 
-        // --- 3. GLAZE ---
+        // --- 2b. TACHYON PARALLEL (stage 1 na wszystkich rdzeniach) ---
         {
+            unpin_all_cores();
+            Tachyon::BasicContext<Tachyon::Mode::Turbo> ctx;
+            ctx.doc->index_threads = 0;
+            std::vector<double> times;
+
+            for(int i = 0; i < warmup; ++i) {
+                Tachyon::json doc = ctx.parse_view(job.ptr, job.size);
+                if (doc.is_array()) do_not_optimize(doc.size());
+                else do_not_optimize(doc.contains("type"));
+            }
+
+            for (int i = 0; i < iters; ++i) {
+                auto start = std::chrono::high_resolution_clock::now();
+                Tachyon::json doc = ctx.parse_view(job.ptr, job.size);
+                if (doc.is_array()) do_not_optimize(doc.size());
+                else do_not_optimize(doc.contains("type"));
+                auto end = std::chrono::high_resolution_clock::now();
+                times.push_back(std::chrono::duration<double>(end - start).count());
+            }
+            pin_to_core(0);
+            auto s = calculate_stats(times, job.size);
+            std::cout << "| Tachyon (Parallel) | " << std::setw(12) << std::setprecision(2) << s.mb_s
+                      << " | " << std::setprecision(12) << s.median_time << " |" << std::endl;
+        }
+
+        // --- 2c. TACHYON UTF-8 (walidacja Titan vs indeksowanie Turbo) ---
+        {
+            std::vector<double> times;
+            bool ok = true;
+
+            for(int i = 0; i < warmup; ++i) {
+                ok &= Tachyon::ASM::validate_utf8(job.ptr, job.size);
+            }
+
+            for (int i = 0; i < iters; ++i) {
+                auto start = std::chrono::high_resolution_clock::now();
+                ok &= Tachyon::ASM::validate_utf8(job.ptr, job.size);
+                auto end = std::chrono::high_resolution_clock::now();
+                times.push_back(std::chrono::duration<double>(end - start).count());
+            }
+            do_not_optimize(ok);
+            auto s = calculate_stats(times, job.size);
+            std::cout << "| Tachyon (UTF-8 " << (ok ? "OK" : "BAD") << ") | " << std::setw(12) << std::setprecision(2) << s.mb_s
+                      << " | " << std::setprecision(12) << s.median_time << " |" << std::endl;
+        }
+
+        // --- 3. GLAZE ---
+        if (job.size < 0xFFFFFFFFull) { // pełny DOM > 4 GiB nie mieści się w pamięci
             std::vector<double> times;
             glz::generic v;
             
@@ -3,11 +3,9 @@
 #include <string>
 #include <vector>
 #include <random>
+#include <cstring>
 
-int main() {
-    std::string filename = "huge.json";
-    size_t target_size = 256 * 1024 * 1024; // 256MB
-
+size_t write_array(const std::string& filename, size_t target_size) {
     std::ofstream f(filename, std::ios::binary);
     f << "[";
 
@@ -28,8 +26,19 @@ int main() {
 
     f << "]";
     f.close();
+    return current_size;
+}
+
+int main(int argc, char** argv) {
+    size_t current_size = write_array("huge.json", 256 * 1024 * 1024); // 256MB
     std::cout << "Generated huge.json (" << current_size << " bytes)" << std::endl;
 
+    // 64-bit offset coverage: only on request, the file does not fit 32-bit offsets
+    if (argc > 1 && std::strcmp(argv[1], "--large") == 0) {
+        size_t large_size = write_array("huge_4g.json", 4608ULL * 1024 * 1024); // 4.5GB
+        std::cout << "Generated huge_4g.json (" << large_size << " bytes)" << std::endl;
+    }
+
     // Unaligned test
     std::ofstream f_un( "unaligned.json", std::ios::binary);
     // Pad with bytes to make it unaligned relative to 64-byte boundary if loaded at 0
@@ -16,8 +16,6 @@
 #include <cmath>
 #include <stdexcept>
 #include <memory>
-#include <map>
-#include <variant>
 #include <charconv>
 #include <initializer_list>
 #include <functional>
@@ -25,9 +23,13 @@
 #include <sstream>
 #include <new>
 #include <cstdlib>
+#include <cstdio>
 #include <cstdint>
 #include <concepts>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 #ifdef _MSC_VER
 #include <intrin.h>
@@ -50,6 +52,15 @@
 #define TACHYON_FORCE_INLINE __forceinline
 #endif
 
+// Misuse checks on borrowed lazy nodes (Document::borrow_nodes): on unless NDEBUG
+#ifndef TACHYON_CHECK_BORROWS
+#ifdef NDEBUG
+#define TACHYON_CHECK_BORROWS 0
+#else
+#define TACHYON_CHECK_BORROWS 1
+#endif
+#endif
+
 namespace Tachyon {
 
     // -------------------------------------------------------------------------
@@ -62,46 +73,134 @@ namespace Tachyon {
         Titan       // Full Validation, Error Context
     };
 
+    // What each mode checks, fixed at compile time by BasicContext<M>,
+    // Document::parse_view<M> and json::parse<M>. Turbo and Apex index without
+    // JSONC and never validate, so none of it reaches their hot paths; Standard
+    // follows Document's runtime `jsonc` / `validate` flags; Titan always validates.
+    template<Mode M>
+    struct ModeTraits {
+        static constexpr bool jsonc = M == Mode::Standard || M == Mode::Titan;   // Honors Document::jsonc
+        static constexpr bool validate = M == Mode::Titan;                       // Always runs the validating index
+        static constexpr bool optional_validate = M == Mode::Standard;           // Honors Document::validate
+        static constexpr bool skip_comments = M == Mode::Standard;               // Cursors step over comments a plain index kept
+    };
+
+    // Ordered from least to most capable
     enum class ISA {
+        Scalar,
+        SSE42,
         AVX2,
         AVX512
     };
 
-    static ISA g_active_isa = ISA::AVX2;
+    // Kernel families selected independently by the dispatch registry
+    enum class Kernel {
+        Index,       // Stage 1 structural indexing
+        Whitespace,  // skip_whitespace
+        Utf8,        // UTF-8 validation
+        Size,        // Bracket depth scans (lazy_size, container skipping)
+        Tape,        // Bitmask flattening
+        Lines,       // Newline counting for error locations (ParseError)
+        Count
+    };
 
-    inline const char* get_isa_name() {
-        return g_active_isa == ISA::AVX512 ? "AVX-512" : "AVX2";
+    inline const char* get_isa_name(ISA isa) {
+        switch (isa) {
+            case ISA::AVX512: return "AVX-512";
+            case ISA::AVX2: return "AVX2";
+            case ISA::SSE42: return "SSE4.2";
+            default: return "Scalar";
+        }
     }
 
     // -------------------------------------------------------------------------
-    // HARDWARE LOCK
+    // DISPATCH REGISTRY
     // -------------------------------------------------------------------------
-    struct HardwareGuard {
-        HardwareGuard() {
+    // One instance per process (inline variable), so CPUID runs once no matter
+    // how many translation units include this header. TACHYON_ISA overrides the
+    // tier of every kernel and TACHYON_ISA_<KERNEL> (INDEX, WHITESPACE, UTF8,
+    // SIZE, TAPE, LINES) a single one, e.g. TACHYON_ISA=avx2 on hosts where
+    // AVX-512 downclocking hurts the rest of the process. Requests above the
+    // detected tier are clamped; unknown names are ignored, so a typo in a
+    // per-kernel variable keeps the TACHYON_ISA choice. Zero-initialized
+    // storage reads as ISA::Scalar, so the library stays usable from other
+    // static initializers.
+    class Dispatch {
+    public:
+        ISA detected = ISA::Scalar;
+        bool clmul = false;    // PCLMULQDQ
+        bool vbmi = false;     // AVX512-VBMI (byte permutes)
+        bool gfni = false;     // GFNI next to AVX512-VBMI (bit-matrix transposes)
+        bool vbmi2 = false;    // AVX512-VBMI2, VPCLMULQDQ and BMI2 next to GFNI (the fused validating index)
+
+        Dispatch() {
+            detect();
+            set_all(detected);
+            ISA isa;
+            if (const char* env = std::getenv("TACHYON_ISA"); env && parse(env, isa)) set_all(isa);
+            static const char* const vars[] = { "TACHYON_ISA_INDEX", "TACHYON_ISA_WHITESPACE", "TACHYON_ISA_UTF8", "TACHYON_ISA_SIZE", "TACHYON_ISA_TAPE", "TACHYON_ISA_LINES" };
+            static_assert(std::size(vars) == (size_t)Kernel::Count, "one variable per kernel family");
+            for (size_t k = 0; k < (size_t)Kernel::Count; ++k) {
+                if (const char* env = std::getenv(vars[k]); env && parse(env, isa)) set((Kernel)k, isa);
+            }
+        }
+
+        ISA get(Kernel k) const { return kernels[(size_t)k].load(std::memory_order_relaxed); }
+        void set(Kernel k, ISA isa) { kernels[(size_t)k].store(std::min(isa, detected), std::memory_order_relaxed); }
+        void set_all(ISA isa) { for (size_t k = 0; k < (size_t)Kernel::Count; ++k) set((Kernel)k, isa); }
+
+    private:
+        std::atomic<ISA> kernels[(size_t)Kernel::Count];
+
+        void detect() {
             bool has_avx2 = false;
+            bool has_sse42 = false;
+            bool has_avx512 = false;
 #ifdef _MSC_VER
             int cpuInfo[4];
             __cpuid(cpuInfo, 7);
             has_avx2 = (cpuInfo[1] & (1 << 5)) != 0;
+            __cpuid(cpuInfo, 1);
+            clmul = (cpuInfo[2] & (1 << 1)) != 0;
+            has_sse42 = (cpuInfo[2] & (1 << 20)) != 0 && (cpuInfo[2] & (1 << 23)) != 0;
 #else
             __builtin_cpu_init();
             has_avx2 = __builtin_cpu_supports("avx2");
+            has_sse42 = __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
+            has_avx512 = __builtin_cpu_supports("avx512f") &&
+                         __builtin_cpu_supports("avx512bw") &&
+                         __builtin_cpu_supports("avx512dq");
+            clmul = __builtin_cpu_supports("pclmul");
+            vbmi = has_avx512 && __builtin_cpu_supports("avx512vbmi");
+            gfni = vbmi && __builtin_cpu_supports("gfni");
+            vbmi2 = gfni && __builtin_cpu_supports("avx512vbmi2") && __builtin_cpu_supports("vpclmulqdq") && __builtin_cpu_supports("bmi2");
 #endif
-            if (!has_avx2) {
-                std::cerr << "FATAL ERROR: Tachyon requires a CPU with AVX2 support." << std::endl;
-                std::terminate();
-            }
+            // No hard requirement: older hosts fall back to the SSE4.2 or portable engines
+            if (has_avx2 && has_avx512) detected = ISA::AVX512;
+            else if (has_avx2) detected = ISA::AVX2;
+            else if (has_sse42) detected = ISA::SSE42;
+            else detected = ISA::Scalar;
+        }
 
-#ifndef _MSC_VER
-            if (__builtin_cpu_supports("avx512f") &&
-                __builtin_cpu_supports("avx512bw") &&
-                __builtin_cpu_supports("avx512dq")) {
-                g_active_isa = ISA::AVX512;
-            }
-#endif
+        // False for an unknown name
+        static bool parse(std::string_view name, ISA& isa) {
+            if (name == "avx512" || name == "AVX512" || name == "AVX-512") isa = ISA::AVX512;
+            else if (name == "avx2" || name == "AVX2") isa = ISA::AVX2;
+            else if (name == "sse42" || name == "SSE42" || name == "SSE4.2") isa = ISA::SSE42;
+            else if (name == "scalar" || name == "Scalar") isa = ISA::Scalar;
+            else return false;
+            return true;
         }
     };
-    static HardwareGuard g_hardware_guard;
+    inline Dispatch g_dispatch;
+
+    // Active tier of a kernel family
+    inline ISA get_isa(Kernel k = Kernel::Index) { return g_dispatch.get(k); }
+    inline const char* get_isa_name() { return get_isa_name(get_isa()); }
+
+    // Runtime override for A/B testing; applies from the next parse on
+    inline void set_isa(ISA isa) { g_dispatch.set_all(isa); }
+    inline void set_isa(Kernel k, ISA isa) { g_dispatch.set(k, isa); }
 
     // -------------------------------------------------------------------------
     // FORWARD DECLARATIONS
@@ -213,324 +312,3185 @@ namespace Tachyon {
             return p;
         }
 
+        // SSE4.2 Skip Whitespace (PCMPESTRI against the whitespace set)
+        [[nodiscard]] __attribute__((target("sse4.2"))) inline const char* skip_whitespace_sse42(const char* p, const char* end) {
+            const __m128i v_ws = _mm_setr_epi8(' ', '\t', '\n', '\r', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+            while (p + 16 <= end) {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                int idx = _mm_cmpestri(v_ws, 4, chunk, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_NEGATIVE_POLARITY | _SIDD_LEAST_SIGNIFICANT);
+                if (idx != 16) return p + idx;
+                p += 16;
+            }
+            while (p < end && (unsigned char)*p <= 32) p++;
+            return p;
+        }
+
+        // Portable Skip Whitespace (SWAR, 8 bytes per step)
+        [[nodiscard]] inline const char* skip_whitespace_scalar(const char* p, const char* end) {
+            constexpr uint64_t ones = 0x0101010101010101ULL;
+            constexpr uint64_t low7 = 0x7F7F7F7F7F7F7F7FULL;
+            // High bit set in every byte of `v` equal to `c`, without false positives
+            auto eq = [](uint64_t v, uint64_t c) {
+                uint64_t x = v ^ (c * ones);
+                return ~(((x & low7) + low7) | x | low7);
+            };
+            while (p + 8 <= end) {
+                uint64_t v;
+                std::memcpy(&v, p, 8);
+                uint64_t ws = eq(v, ' ') | eq(v, '\t') | eq(v, '\n') | eq(v, '\r');
+                uint64_t other = ~ws & ~low7;
+                if (other) return p + std::countr_zero(other) / 8;
+                p += 8;
+            }
+            while (p < end && (unsigned char)*p <= 32) p++;
+            return p;
+        }
+
         inline const char* skip_whitespace(const char* p, const char* end) {
-            if (g_active_isa == ISA::AVX512) return skip_whitespace_avx512(p, end);
-            return skip_whitespace_avx2(p, end);
+            ISA isa = get_isa(Kernel::Whitespace);
+            if (isa == ISA::AVX512) return skip_whitespace_avx512(p, end);
+            if (isa == ISA::AVX2) return skip_whitespace_avx2(p, end);
+            if (isa == ISA::SSE42) return skip_whitespace_sse42(p, end);
+            return skip_whitespace_scalar(p, end);
+        }
+
+        // ---------------------------------------------------------------------
+        // LINE SCAN (Error Locations)
+        // ---------------------------------------------------------------------
+        // Counts the newlines of [data, data + len) and finds where the last line
+        // starts: all a byte offset needs to become a line and column. Runs once per
+        // reported error, so the vector tiers just stream popcounts of newline masks.
+        struct LineScan { size_t newlines = 0; size_t line_start = 0; };
+
+        TACHYON_FORCE_INLINE void scan_line_word(LineScan& r, uint64_t nl, size_t at) {
+            r.newlines += std::popcount(nl);
+            if (nl) r.line_start = at + 64 - std::countl_zero(nl);
+        }
+
+        __attribute__((target("avx512f,avx512bw,popcnt,lzcnt")))
+        inline LineScan scan_lines_avx512(const char* data, size_t len) {
+            const __m512i v_nl = _mm512_set1_epi8('\n');
+            LineScan r;
+            size_t i = 0;
+            for (; i + 64 <= len; i += 64) {
+                __m512i chunk = _mm512_loadu_si512(reinterpret_cast<const __m512i*>(data + i));
+                scan_line_word(r, _mm512_cmpeq_epi8_mask(chunk, v_nl), i);
+            }
+            if (i < len) {
+                __m512i chunk = _mm512_maskz_loadu_epi8(~0ULL >> (64 - (len - i)), data + i);
+                scan_line_word(r, _mm512_cmpeq_epi8_mask(chunk, v_nl), i);
+            }
+            _mm256_zeroupper();
+            return r;
+        }
+
+        __attribute__((target("avx2,popcnt,lzcnt")))
+        inline LineScan scan_lines_avx2(const char* data, size_t len) {
+            const __m256i v_nl = _mm256_set1_epi8('\n');
+            LineScan r;
+            size_t i = 0;
+            for (; i + 64 <= len; i += 64) {
+                __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+                __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32));
+                uint64_t nl = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, v_nl)) |
+                              ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, v_nl)) << 32);
+                scan_line_word(r, nl, i);
+            }
+            for (; i < len; ++i) {
+                if (data[i] == '\n') { r.newlines++; r.line_start = i + 1; }
+            }
+            return r;
+        }
+
+        inline LineScan scan_lines_scalar(const char* data, size_t len) {
+            LineScan r;
+            for (size_t i = 0; i < len; ++i) {
+                if (data[i] == '\n') { r.newlines++; r.line_start = i + 1; }
+            }
+            return r;
+        }
+
+        inline LineScan scan_lines(const char* data, size_t len) {
+            ISA isa = get_isa(Kernel::Lines);
+            if (isa == ISA::AVX512) return scan_lines_avx512(data, len);
+            if (isa == ISA::AVX2) return scan_lines_avx2(data, len);
+            return scan_lines_scalar(data, len);
         }
 
         // ---------------------------------------------------------------------
         // UTF-8 VALIDATION (Titan Mode)
         // ---------------------------------------------------------------------
+        // Vector tiers use the lookup scheme of Keiser & Lemire: each byte pair
+        // (prev1, cur) is classified through three nibble tables whose AND is
+        // non-zero only for an invalid pair, and 3/4-byte leads additionally
+        // require continuations at prev2/prev3. Error bits:
+        //   TOO_SHORT  0x01  lead followed by a non-continuation
+        //   TOO_LONG   0x02  ASCII followed by a continuation
+        //   OVERLONG_3 0x04  E0 80..9F
+        //   TOO_LARGE  0x08  F4 90..BF, F5..FF
+        //   SURROGATE  0x10  ED A0..BF
+        //   OVERLONG_2 0x20  C0..C1
+        //   OVERLONG_4 0x40  F0 80..8F (TOO_LARGE_1000 shares the bit: F5..FF 80..8F)
+        //   TWO_CONTS  0x80  continuation after continuation (cleared again where
+        //                    prev2/prev3 demand a 3rd/4th byte)
+        // A 16-byte PSHUFB table repeated across the four lanes of a ZMM register.
+        // Loaded whole: GCC's _mm512_broadcast_i32x4 merges into an undefined
+        // register, which -Wall reports as used uninitialized.
+        template<const uint8_t (&Table)[16]>
+        alignas(64) inline constexpr auto zmm_table = [] {
+            struct { uint8_t v[64] = {}; } t;
+            for (int i = 0; i < 64; ++i) t.v[i] = Table[i % 16];
+            return t;
+        }();
+
+        alignas(16) inline constexpr uint8_t utf8_byte_1_high[16] = {
+            0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,  // 0_______ ASCII
+            0x80, 0x80, 0x80, 0x80,                          // 10______ continuation
+            0x21, 0x01, 0x15, 0x49                           // 1100, 1101, 1110, 1111 leads
+        };
+        alignas(16) inline constexpr uint8_t utf8_byte_1_low[16] = {
+            0xE7, 0xA3, 0x83, 0x83, 0x8B, 0xCB, 0xCB, 0xCB,
+            0xCB, 0xCB, 0xCB, 0xCB, 0xCB, 0xDB, 0xCB, 0xCB
+        };
+        alignas(16) inline constexpr uint8_t utf8_byte_2_high[16] = {
+            0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,  // ASCII after a lead
+            0xE6, 0xAE, 0xBA, 0xBA,                          // 1000, 1001, 101_ continuations
+            0x01, 0x01, 0x01, 0x01                           // lead after a lead
+        };
+        // A block ending in one of these still owes continuation bytes:
+        // last byte >= C0, second-to-last >= E0, third-to-last >= F0
+        inline constexpr uint8_t utf8_incomplete_max[3] = { 0xEF, 0xDF, 0xBF };
+
         __attribute__((target("avx2")))
         inline bool validate_utf8_avx2(const char* data, size_t len) {
-            // Simplified vector validation for AVX2
-            const __m256i v_128 = _mm256_set1_epi8(0x80);
+            const __m256i v_128 = _mm256_set1_epi8((char)0x80);
+            const __m256i v_0f = _mm256_set1_epi8(0x0F);
+            const __m256i t_1_high = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_1_high)));
+            const __m256i t_1_low = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_1_low)));
+            const __m256i t_2_high = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(utf8_byte_2_high)));
+            const __m256i v_max = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                   (char)utf8_incomplete_max[0], (char)utf8_incomplete_max[1], (char)utf8_incomplete_max[2]);
+            const __m256i v_third = _mm256_set1_epi8((char)(0xE0 - 0x80));
+            const __m256i v_fourth = _mm256_set1_epi8((char)(0xF0 - 0x80));
+
+            __m256i prev_input = _mm256_setzero_si256();
+            __m256i prev_incomplete = _mm256_setzero_si256();
+            __m256i error = _mm256_setzero_si256();
+
+            auto check = [&](__m256i input) __attribute__((target("avx2"), always_inline)) {
+                if (_mm256_testz_si256(input, v_128)) {
+                    // All ASCII: only an unfinished sequence from the last block can fail
+                    error = _mm256_or_si256(error, prev_incomplete);
+                    prev_incomplete = _mm256_setzero_si256();
+                } else {
+                    // Bytes shifted in from the previous block: prev1/prev2/prev3
+                    __m256i carry = _mm256_permute2x128_si256(prev_input, input, 0x21);
+                    __m256i prev1 = _mm256_alignr_epi8(input, carry, 15);
+                    __m256i prev2 = _mm256_alignr_epi8(input, carry, 14);
+                    __m256i prev3 = _mm256_alignr_epi8(input, carry, 13);
+                    __m256i b1h = _mm256_shuffle_epi8(t_1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), v_0f));
+                    __m256i b1l = _mm256_shuffle_epi8(t_1_low, _mm256_and_si256(prev1, v_0f));
+                    __m256i b2h = _mm256_shuffle_epi8(t_2_high, _mm256_and_si256(_mm256_srli_epi16(input, 4), v_0f));
+                    __m256i special = _mm256_and_si256(_mm256_and_si256(b1h, b1l), b2h);
+                    __m256i must23 = _mm256_or_si256(_mm256_subs_epu8(prev2, v_third), _mm256_subs_epu8(prev3, v_fourth));
+                    error = _mm256_or_si256(error, _mm256_xor_si256(_mm256_and_si256(must23, v_128), special));
+                    prev_incomplete = _mm256_subs_epu8(input, v_max);
+                }
+                prev_input = input;
+            };
+
             size_t i = 0;
             for (; i + 32 <= len; i += 32) {
-                __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
-                if (_mm256_testz_si256(chunk, v_128)) continue; // All ASCII
+                check(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
             }
-            return true;
+            if (i < len) {
+                // Zero padding reads as ASCII, so a sequence cut by the end fails as TOO_SHORT
+                alignas(32) char tail[32] = {};
+                std::memcpy(tail, data + i, len - i);
+                check(_mm256_load_si256(reinterpret_cast<const __m256i*>(tail)));
+            }
+            error = _mm256_or_si256(error, prev_incomplete);
+            return _mm256_testz_si256(error, error);
         }
 
         __attribute__((target("avx512f,avx512bw")))
         inline bool validate_utf8_avx512(const char* data, size_t len) {
-             // AVX-512 "God Mode" UTF-8
-             const __m512i v_128 = _mm512_set1_epi8(0x80);
-             size_t i = 0;
-             for (; i + 64 <= len; i += 64) {
-                 __m512i chunk = _mm512_loadu_si512(reinterpret_cast<const __m512i*>(data + i));
-                 // Check if any high bit set
-                 if (_mm512_test_epi8_mask(chunk, v_128) == 0) continue;
-             }
-             _mm256_zeroupper();
-             return true;
+            const __m512i v_128 = _mm512_set1_epi8((char)0x80);
+            const __m512i v_0f = _mm512_set1_epi8(0x0F);
+            const __m512i t_1_high = _mm512_load_si512(zmm_table<utf8_byte_1_high>.v);
+            const __m512i t_1_low = _mm512_load_si512(zmm_table<utf8_byte_1_low>.v);
+            const __m512i t_2_high = _mm512_load_si512(zmm_table<utf8_byte_2_high>.v);
+            // All-ones except the last three bytes of the register
+            const __m512i v_max = _mm512_set_epi64((long long)(0x000000FFFFFFFFFFULL | ((uint64_t)utf8_incomplete_max[0] << 40) |
+                                                                ((uint64_t)utf8_incomplete_max[1] << 48) | ((uint64_t)utf8_incomplete_max[2] << 56)),
+                                                   -1, -1, -1, -1, -1, -1, -1);
+            const __m512i v_third = _mm512_set1_epi8((char)(0xE0 - 0x80));
+            const __m512i v_fourth = _mm512_set1_epi8((char)(0xF0 - 0x80));
+
+            __m512i prev_input = _mm512_setzero_si512();
+            __m512i prev_incomplete = _mm512_setzero_si512();
+            __m512i error = _mm512_setzero_si512();
+
+            auto check = [&](__m512i input) __attribute__((target("avx512f,avx512bw"), always_inline)) {
+                if (_mm512_movepi8_mask(input) == 0) {
+                    error = _mm512_or_si512(error, prev_incomplete);
+                    prev_incomplete = _mm512_setzero_si512();
+                } else {
+                    // Each 128-bit lane paired with the lane before it (lane 0 with the previous block).
+                    // Full-mask maskz form: the same VALIGNQ without the undefined merge source
+                    __m512i carry = _mm512_maskz_alignr_epi64(0xFF, input, prev_input, 6);
+                    __m512i prev1 = _mm512_alignr_epi8(input, carry, 15);
+                    __m512i prev2 = _mm512_alignr_epi8(input, carry, 14);
+                    __m512i prev3 = _mm512_alignr_epi8(input, carry, 13);
+                    __m512i b1h = _mm512_shuffle_epi8(t_1_high, _mm512_and_si512(_mm512_srli_epi16(prev1, 4), v_0f));
+                    __m512i b1l = _mm512_shuffle_epi8(t_1_low, _mm512_and_si512(prev1, v_0f));
+                    __m512i b2h = _mm512_shuffle_epi8(t_2_high, _mm512_and_si512(_mm512_srli_epi16(input, 4), v_0f));
+                    __m512i special = _mm512_ternarylogic_epi32(b1h, b1l, b2h, 0x80);  // a & b & c
+                    __m512i must23 = _mm512_or_si512(_mm512_subs_epu8(prev2, v_third), _mm512_subs_epu8(prev3, v_fourth));
+                    error = _mm512_or_si512(error, _mm512_xor_si512(_mm512_and_si512(must23, v_128), special));
+                    prev_incomplete = _mm512_subs_epu8(input, v_max);
+                }
+                prev_input = input;
+            };
+
+            size_t i = 0;
+            for (; i + 64 <= len; i += 64) {
+                check(_mm512_loadu_si512(reinterpret_cast<const __m512i*>(data + i)));
+            }
+            if (i < len) {
+                // Masked load zero-fills past the end (reads as ASCII, see AVX2)
+                check(_mm512_maskz_loadu_epi8(~0ULL >> (64 - (len - i)), data + i));
+            }
+            error = _mm512_or_si512(error, prev_incomplete);
+            bool ok = _mm512_test_epi8_mask(error, error) == 0;
+            _mm256_zeroupper();
+            return ok;
+        }
+
+        // Portable UTF-8 (SSE4.2 / Scalar tiers): ASCII runs 8 bytes at a time,
+        // multi-byte sequences checked for overlongs, surrogates and > U+10FFFF.
+        // Returns the offset of the first invalid or truncated sequence, or len.
+        inline size_t utf8_error_offset(const char* data, size_t len) {
+            const unsigned char* s = reinterpret_cast<const unsigned char*>(data);
+            size_t i = 0;
+            while (i < len) {
+                if (i + 8 <= len) {
+                    uint64_t v;
+                    std::memcpy(&v, s + i, 8);
+                    if ((v & 0x8080808080808080ULL) == 0) { i += 8; continue; }
+                }
+                unsigned char c = s[i];
+                if (c < 0x80) { i++; continue; }
+                size_t n;
+                unsigned char lo = 0x80, hi = 0xBF;
+                if (c >= 0xC2 && c <= 0xDF) n = 1;
+                else if (c >= 0xE0 && c <= 0xEF) { n = 2; if (c == 0xE0) lo = 0xA0; else if (c == 0xED) hi = 0x9F; }
+                else if (c >= 0xF0 && c <= 0xF4) { n = 3; if (c == 0xF0) lo = 0x90; else if (c == 0xF4) hi = 0x8F; }
+                else return i;
+                if (i + n >= len) return i;  // Truncated sequence
+                if (s[i + 1] < lo || s[i + 1] > hi) return i;
+                for (size_t k = 2; k <= n; ++k) if ((s[i + k] & 0xC0) != 0x80) return i;
+                i += n + 1;
+            }
+            return len;
+        }
+
+        inline bool validate_utf8_scalar(const char* data, size_t len) {
+            return utf8_error_offset(data, len) == len;
+        }
+
+        inline bool validate_utf8(const char* data, size_t len) {
+            ISA isa = get_isa(Kernel::Utf8);
+            if (isa == ISA::AVX512) return validate_utf8_avx512(data, len);
+            if (isa == ISA::AVX2) return validate_utf8_avx2(data, len);
+            return validate_utf8_scalar(data, len);
         }
     }
 
     namespace SIMD {
 
-        using MaskFunction = size_t(*)(const char*, size_t, uint32_t*);
+        // Indexer state carried across consecutive blocks of one buffer
+        struct IndexState {
+            uint64_t prev_escaped = 0;  // First byte of the next block is escaped (0/1)
+            uint64_t in_string = 0;     // All-ones while inside a string
+            uint64_t prev_scalar = 0;   // Last byte of the previous block belongs to a scalar (0/1)
+            uint64_t comment = 0;       // JSONC: inside a line (1) or block (2) comment
+            uint64_t comment_edge = 0;  // JSONC: last byte was a '/' or '*' awaiting the next (0/1)
+        };
+
+        // `alt_mask_array` (optional) receives the mask the same bytes would produce
+        // had they been entered inside a string. The parallel indexer uses it to fix
+        // up speculatively indexed chunks without re-reading them.
+        // `float_mask_array` (optional) receives the raw positions of '.', 'e' and 'E',
+        // so a number's type is a mask lookup over its span.
+        using MaskFunction = size_t(*)(const char*, size_t, uint64_t*, IndexState&, uint64_t*, uint64_t*);
+
+        // ---------------------------------------------------------------------
+        // ESCAPE RESOLUTION (Branchless)
+        // ---------------------------------------------------------------------
+        // Returns the characters escaped by an odd-length run of backslashes.
+        // `prev_escaped` carries "first byte of the next block is escaped" (0/1)
+        // across blocks, so runs that straddle a block boundary resolve correctly.
+        template<typename Word>
+        TACHYON_FORCE_INLINE Word find_escaped(Word bs_mask, Word& prev_escaped) {
+            constexpr Word even_bits = static_cast<Word>(0x5555555555555555ULL);
+            bs_mask &= ~prev_escaped;
+            Word follows_escape = (bs_mask << 1) | prev_escaped;
+            Word odd_starts = bs_mask & ~even_bits & ~follows_escape;
+            Word even_runs;
+            prev_escaped = __builtin_add_overflow(odd_starts, bs_mask, &even_runs);
+            Word invert_mask = even_runs << 1;
+            return (even_bits ^ invert_mask) & follows_escape;
+        }
+
+        // ---------------------------------------------------------------------
+        // PREFIX XOR (In-String Region)
+        // ---------------------------------------------------------------------
+        TACHYON_FORCE_INLINE uint64_t prefix_xor(uint64_t p) {
+            p ^= (p << 1); p ^= (p << 2); p ^= (p << 4); p ^= (p << 8); p ^= (p << 16); p ^= (p << 32);
+            return p;
+        }
+
+        // Carry-less multiply by all-ones yields the same prefix XOR in a single instruction.
+        __attribute__((target("pclmul")))
+        TACHYON_FORCE_INLINE uint64_t prefix_xor_clmul(uint64_t p) {
+            __m128i v_p = _mm_set_epi64x(0, (int64_t)p);
+            return (uint64_t)_mm_cvtsi128_si64(_mm_clmulepi64_si128(v_p, _mm_set1_epi8((char)0xFF), 0));
+        }
+
+        // ---------------------------------------------------------------------
+        // CHARACTER CLASSIFICATION (Shared by all engines)
+        // ---------------------------------------------------------------------
+        // Structural set: { } [ ] : , and the JSONC '/'. Every engine must index
+        // exactly this set so cursors behave the same on any tier. The Jsonc
+        // variants drop '/' along with the comments it opens.
+
+        // Class bits: 0xE0 structural, 0x01 quote, 0x02 backslash, 0x0C whitespace.
+        // A byte carries at most one class, so "structural" is simply class >= 0x20.
+        constexpr uint8_t CLASS_STRUCT = 0xE0;
+        constexpr uint8_t CLASS_QUOTE = 0x01;
+        constexpr uint8_t CLASS_BACKSLASH = 0x02;
+        constexpr uint8_t CLASS_WHITESPACE = 0x0C;
+        constexpr uint8_t CLASS_FLOAT = 0x10;   // '.', 'e', 'E' (direct table only)
+        constexpr uint8_t CLASS_NON_SCALAR = CLASS_STRUCT | CLASS_QUOTE | CLASS_WHITESPACE;
+
+        // Nibble tables (PSHUFB): class = lo[c & 0xF] & hi[c >> 4]. Structural and
+        // whitespace bits differ per high-nibble group (0x80 for , /  0x40 for :
+        // 0x20 for brackets; 0x04 for \t \n \r, 0x08 for space) so neighbours
+        // sharing a low nibble ('+', '-', '*', 'z', '|') never match.
+        alignas(16) inline constexpr uint8_t nibble_lo_table[16] = { 0x08, 0, 0x01, 0, 0, 0, 0, 0, 0, 0x04, 0x44, 0x20, 0x82, 0x24, 0, 0x80 };
+        alignas(16) inline constexpr uint8_t nibble_hi_table[16] = { 0x04, 0, 0x89, 0x40, 0, 0x22, 0, 0x20, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+        // Direct table (portable engine; VPERMI2B over its ASCII half)
+        alignas(64) inline constexpr auto byte_class_table = [] {
+            struct { uint8_t v[256] = {}; } t;
+            for (unsigned char c : {'{', '}', '[', ']', ':', ',', '/'}) t.v[c] = 0x20;
+            for (unsigned char c : {' ', '\t', '\n', '\r'}) t.v[c] = 0x04;
+            for (unsigned char c : {'.', 'e', 'E'}) t.v[c] = CLASS_FLOAT;
+            t.v[(unsigned char)'"'] = CLASS_QUOTE;
+            t.v[(unsigned char)'\\'] = CLASS_BACKSLASH;
+            return t;
+        }();
+
+        // ---------------------------------------------------------------------
+        // SCALAR VALUE STARTS (Pseudo-Structural)
+        // ---------------------------------------------------------------------
+        // The first byte of every run of bytes that are not whitespace, structural
+        // or quotes, i.e. where a number or true/false/null begins. Indexed next to
+        // the structurals, every value start is a token, so navigation lands on a
+        // value directly instead of rescanning whitespace after each delimiter.
+        // `prev_scalar` carries "previous block ended inside such a run" (0/1).
+        TACHYON_FORCE_INLINE uint64_t find_scalar_starts(uint64_t scalar_chars, uint64_t& prev_scalar) {
+            uint64_t starts = scalar_chars & ~((scalar_chars << 1) | prev_scalar);
+            prev_scalar = scalar_chars >> 63;
+            return starts;
+        }
+
+        // ---------------------------------------------------------------------
+        // JSONC COMMENT REGIONS
+        // ---------------------------------------------------------------------
+        // Strings and comments hide each other ("//" in a string is text, a quote
+        // in a comment opens nothing), so one prefix XOR cannot resolve both. A
+        // word with no '/' outside strings and no comment carried in keeps the
+        // plain path. Any other word alternates between code, where a prefix XOR
+        // over the quotes skips every string up to the next opener, and comment
+        // bodies, ended by a tzcnt to the next newline or "*/": two steps per
+        // comment, never a byte loop. Returns the bytes inside comments,
+        // delimiters included. `comment` carries 1 inside a line comment and 2
+        // inside a block comment; `comment_edge` a '/' in code or a '*' in a
+        // block comment as the last byte, whose meaning the next word decides.
+        // A '/' in code at bit 63 stays a token until then: `retract` is set when
+        // this word's first byte turns it into a comment opener, and the caller
+        // clears bit 63 of the previous word.
+        TACHYON_FORCE_INLINE uint64_t find_comments(uint64_t quote, uint64_t slash, uint64_t star, uint64_t newline, uint64_t in_string, uint64_t& comment, uint64_t& comment_edge, uint64_t& retract) {
+            auto from = [](int pos) { return pos >= 64 ? 0 : ~0ULL << pos; };
+            uint64_t inside = 0;
+            int pos = 0;
+            retract = 0;
+            if (comment_edge) {
+                comment_edge = 0;
+                if (comment == 0 && ((slash | star) & 1)) { comment = (slash & 1) ? 1 : 2; inside = 1; pos = 1; retract = 1; }
+                else if (comment == 2 && (slash & 1)) { comment = 0; inside = 1; pos = 1; }
+            }
+            while (pos < 64) {
+                if (comment == 1) {
+                    uint64_t m = newline & from(pos);
+                    if (!m) { inside |= from(pos); break; }
+                    int e = std::countr_zero(m);  // The newline itself is whitespace again
+                    inside |= from(pos) & ~from(e);
+                    pos = e;
+                    comment = 0;
+                } else if (comment == 2) {
+                    uint64_t m = star & (slash >> 1) & from(pos);
+                    if (!m) { inside |= from(pos); comment_edge = star >> 63; break; }
+                    int e = std::countr_zero(m) + 2;
+                    inside |= from(pos) & ~from(e);
+                    pos = e;
+                    comment = 0;
+                } else {
+                    uint64_t strings = prefix_xor(quote & from(pos)) ^ (in_string & from(pos));
+                    uint64_t m = slash & ~strings & from(pos);
+                    if (!m) break;
+                    in_string = 0;
+                    int e = std::countr_zero(m);
+                    if (e == 63) { comment_edge = 1; break; }
+                    if (((slash | star) >> (e + 1)) & 1) {
+                        comment = ((slash >> (e + 1)) & 1) ? 1 : 2;
+                        inside |= 3ULL << e;
+                        pos = e + 2;  // "/*/" does not close itself
+                    } else {
+                        pos = e + 1;  // A lone '/'
+                    }
+                }
+            }
+            return inside;
+        }
+
+        // JSONC: drops comments from the structural and quote masks and returns the
+        // string region `p` recomputed without their quotes. A '/' opening a
+        // comment vanishes with it; a lone '/' is not JSON and stays a token, so
+        // Mode::Titan rejects it. `retract` (0/1) asks the caller to clear bit 63
+        // of the previous word (retract_edge).
+        TACHYON_FORCE_INLINE uint64_t strip_comments(uint64_t& struct_mask, uint64_t& quote_mask, uint64_t p, uint64_t in_string, uint64_t slash, uint64_t star, uint64_t newline, uint64_t& comment, uint64_t& comment_edge, uint64_t& retract) {
+            retract = 0;
+            if (TACHYON_LIKELY(!(comment | comment_edge | (slash & ~p)))) return p;
+            uint64_t inside = find_comments(quote_mask, slash, star, newline, in_string, comment, comment_edge, retract);
+            quote_mask &= ~inside;
+            struct_mask &= ~inside;
+            return prefix_xor(quote_mask) ^ in_string;
+        }
+
+        // Drops the '/' at bit 63 of the word before `mask_array[block_idx]`. With
+        // block_idx 0 that word came from the previous call over the same buffer,
+        // which is the only way a carried comment_edge can be set.
+        TACHYON_FORCE_INLINE void retract_edge(uint64_t* mask_array, uint64_t* alt_mask_array, size_t block_idx) {
+            mask_array[(ptrdiff_t)block_idx - 1] &= ~(1ULL << 63);
+            if (alt_mask_array) alt_mask_array[(ptrdiff_t)block_idx - 1] &= ~(1ULL << 63);
+        }
+
+        // For callers that hand out a word before the next one is indexed: settles
+        // a pending '/' at bit 63 of `last_word` by peeking at the byte after it.
+        // The next engine call reaches the same verdict, so settling twice is harmless.
+        TACHYON_FORCE_INLINE void settle_comment_edge(const IndexState& state, uint64_t* last_word, const char* next, const char* end) {
+            if (state.comment_edge && state.comment == 0 && next < end && (*next == '/' || *next == '*')) *last_word &= ~(1ULL << 63);
+        }
 
         // ---------------------------------------------------------------------
         // AVX2 ENGINE
         // ---------------------------------------------------------------------
-        __attribute__((target("avx2")))
-        inline size_t compute_structural_mask_avx2(const char* data, size_t len, uint32_t* mask_array) {
-            static const __m256i v_lo_tbl = _mm256_broadcastsi128_si256(_mm_setr_epi8(0, 0, 0x40, 0, 0, 0, 0, 0, 0, 0, 0x80, 0x80, 0xA0, 0x80, 0, 0x80));
-            static const __m256i v_hi_tbl = _mm256_broadcastsi128_si256(_mm_setr_epi8(0, 0, 0xC0, 0x80, 0, 0xA0, 0, 0x80, 0, 0, 0, 0, 0, 0, 0, 0));
+        template<bool UseClmul = false, bool Jsonc = false>
+        __attribute__((target("avx2,pclmul")))
+        inline size_t compute_structural_mask_avx2(const char* data, size_t len, uint64_t* mask_array, IndexState& state, uint64_t* alt_mask_array = nullptr, uint64_t* float_mask_array = nullptr) {
+            static const __m256i v_lo_tbl = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(nibble_lo_table)));
+            static const __m256i v_hi_tbl = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(nibble_hi_table)));
             static const __m256i v_0f = _mm256_set1_epi8(0x0F);
+            static const __m256i v_60 = _mm256_set1_epi8(0x60);
+            static const __m256i v_non_scalar = _mm256_set1_epi8((char)CLASS_NON_SCALAR);
+            static const __m256i v_20 = _mm256_set1_epi8(0x20);
+            static const __m256i v_dot = _mm256_set1_epi8('.');
+            static const __m256i v_e = _mm256_set1_epi8('e');
 
             size_t i = 0;
             size_t block_idx = 0;
-            uint64_t prev_escapes = 0;
-            uint32_t in_string_mask = 0;
+            uint64_t prev_escaped = state.prev_escaped;
+            uint64_t in_string_mask = state.in_string;
+            uint64_t prev_scalar = state.prev_scalar;
+            uint64_t comment = state.comment;
+            uint64_t comment_edge = state.comment_edge;
+            uint64_t retract = 0;       // JSONC: set by strip_comments, see retract_edge
+
+            // JSONC: '/', '*' and '\n' of a 64-byte word
+            auto comment_chars = [&](const char* ptr, uint64_t& slash, uint64_t& star, uint64_t& newline) __attribute__((target("avx2"), always_inline)) {
+                slash = star = newline = 0;
+                for (int k = 0; k < 2; ++k) {
+                    __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr + 32 * k));
+                    slash |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('/'))) << (32 * k);
+                    star |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('*'))) << (32 * k);
+                    newline |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n'))) << (32 * k);
+                }
+            };
+
+            auto classify = [&](const char* ptr, uint64_t& struct_mask, uint64_t& quote_mask, uint64_t& bs_mask, uint64_t& scalar_mask, uint64_t& float_mask) __attribute__((target("avx2"), always_inline)) {
+                __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+                __m256i lo = _mm256_and_si256(chunk, v_0f);
+                __m256i hi = _mm256_and_si256(_mm256_srli_epi16(chunk, 4), v_0f);
+                __m256i char_class = _mm256_and_si256(_mm256_shuffle_epi8(v_lo_tbl, lo), _mm256_shuffle_epi8(v_hi_tbl, hi));
+                struct_mask = (uint32_t)_mm256_movemask_epi8(_mm256_adds_epu8(char_class, v_60)); // >= 0x20 saturates into bit 7
+                quote_mask = (uint32_t)_mm256_movemask_epi8(_mm256_slli_epi16(char_class, 7));
+                bs_mask = (uint32_t)_mm256_movemask_epi8(_mm256_slli_epi16(char_class, 6));
+                scalar_mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(char_class, v_non_scalar), _mm256_setzero_si256()));
+                if (float_mask_array) {
+                    __m256i fp = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, v_dot), _mm256_cmpeq_epi8(_mm256_or_si256(chunk, v_20), v_e));
+                    float_mask = (uint32_t)_mm256_movemask_epi8(fp);
+                }
+            };
+
+            // Two 32-byte chunks are resolved together as one 64-bit word of `bytes` valid bytes
+            auto resolve = [&](const char* ptr, size_t bytes, uint64_t& alt_mask, uint64_t& float_mask) __attribute__((target("avx2,pclmul"), always_inline)) -> uint64_t {
+                uint64_t s0, q0, b0, c0, f0 = 0, s1, q1, b1, c1, f1 = 0;
+                classify(ptr, s0, q0, b0, c0, f0);
+                classify(ptr + 32, s1, q1, b1, c1, f1);
+                uint64_t load_mask = bytes == 64 ? ~0ULL : (1ULL << bytes) - 1;
+                uint64_t struct_mask = (s0 | (s1 << 32)) & load_mask;
+                uint64_t scalar_mask = (c0 | (c1 << 32)) & load_mask;
+                uint64_t quote_mask = (q0 | (q1 << 32)) & load_mask;
+                uint64_t escaped = find_escaped((b0 | (b1 << 32)) & load_mask, prev_escaped);
+                quote_mask &= ~escaped;
+                struct_mask |= find_scalar_starts(scalar_mask, prev_scalar);
+                float_mask = (f0 | (f1 << 32)) & load_mask;
+
+                uint64_t p;
+                if constexpr (UseClmul) p = prefix_xor_clmul(quote_mask);
+                else p = prefix_xor(quote_mask);
+                p ^= in_string_mask;
+                if constexpr (Jsonc) {
+                    uint64_t slash, star, newline;
+                    comment_chars(ptr, slash, star, newline);
+                    p = strip_comments(struct_mask, quote_mask, p, in_string_mask, slash, star, newline, comment, comment_edge, retract);
+                }
+                in_string_mask = (uint64_t)((int64_t)p >> 63);
+
+                // The carries out of a partial block sit at bit `bytes`, not bit 64
+                if (bytes < 64) {
+                    prev_escaped = (escaped >> bytes) & 1;
+                    prev_scalar = (scalar_mask >> (bytes - 1)) & 1;
+                }
+                alt_mask = (struct_mask & p) | quote_mask;
+                return (struct_mask & ~p) | quote_mask;
+            };
+
+            auto store = [&](uint64_t final_mask, uint64_t alt_mask, uint64_t float_mask) {
+                if (alt_mask_array) {
+                    alt_mask_array[block_idx] = alt_mask;
+                }
+                if (float_mask_array) {
+                    float_mask_array[block_idx] = float_mask;
+                }
+                mask_array[block_idx++] = final_mask;
+            };
+
+            // Streaming stores need 16-byte alignment: a call resumed at an odd word
+            // (a 64-byte split) stores its first word plainly. The alternate and float
+            // masks share the alignment of mask_array.
+            if (((uintptr_t)mask_array & 15) && len >= 128) {
+                uint64_t alt_mask, float_mask;
+                uint64_t final_mask = resolve(data, 64, alt_mask, float_mask);
+                if (Jsonc && retract) retract_edge(mask_array, alt_mask_array, block_idx);
+                store(final_mask, alt_mask, float_mask);
+                i = 64;
+            }
 
             // Register-based accumulation
             for (; i + 128 <= len; i += 128) {
-                uint32_t m0, m1, m2, m3;
-                auto compute_chunk = [&](size_t offset) -> uint32_t {
-                    __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset));
-                    __m256i lo = _mm256_and_si256(chunk, v_0f);
-                    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(chunk, 4), v_0f);
-                    __m256i char_class = _mm256_and_si256(_mm256_shuffle_epi8(v_lo_tbl, lo), _mm256_shuffle_epi8(v_hi_tbl, hi));
-                    uint32_t struct_mask = _mm256_movemask_epi8(char_class);
-                    uint32_t quote_mask = _mm256_movemask_epi8(_mm256_slli_epi16(char_class, 1));
-                    uint32_t bs_mask = _mm256_movemask_epi8(_mm256_slli_epi16(char_class, 2));
-
-                    if (TACHYON_UNLIKELY(bs_mask != 0 || prev_escapes > 0)) {
-                         uint32_t real_quote_mask = 0;
-                         const char* c_ptr = data + offset;
-                         for(int j=0; j<32; ++j) {
-                             if (c_ptr[j] == '"' && (prev_escapes & 1) == 0) real_quote_mask |= (1U << j);
-                             if (c_ptr[j] == '\\') prev_escapes++; else prev_escapes = 0;
-                         }
-                         quote_mask = real_quote_mask;
-                    } else { prev_escapes = 0; }
-
-                    uint32_t p = quote_mask;
-                    p ^= (p << 1); p ^= (p << 2); p ^= (p << 4); p ^= (p << 8); p ^= (p << 16);
-                    p ^= in_string_mask;
-                    uint32_t odd = std::popcount(quote_mask) & 1;
-                    in_string_mask ^= (0 - odd);
-                    return (struct_mask & ~p) | quote_mask;
-                };
-
-                m0 = compute_chunk(i);
-                m1 = compute_chunk(i + 32);
-                m2 = compute_chunk(i + 64);
-                m3 = compute_chunk(i + 96);
+                uint64_t a01, a23, f01, f23;
+                uint64_t m01 = resolve(data + i, 64, a01, f01);
+                if (Jsonc && retract) retract_edge(mask_array, alt_mask_array, block_idx);
+                uint64_t m23 = resolve(data + i + 64, 64, a23, f23);
+                if (Jsonc && retract) { m01 &= ~(1ULL << 63); a01 &= ~(1ULL << 63); }
 
                 _mm_prefetch((const char*)(data + i + 1024), _MM_HINT_T0);
-                __m128i m_pack = _mm_setr_epi32(m0, m1, m2, m3);
+                __m128i m_pack = _mm_set_epi64x((int64_t)m23, (int64_t)m01);
                 _mm_stream_si128((__m128i*)(mask_array + block_idx), m_pack);
-                block_idx += 4;
+                if (alt_mask_array) _mm_stream_si128((__m128i*)(alt_mask_array + block_idx), _mm_set_epi64x((int64_t)a23, (int64_t)a01));
+                if (float_mask_array) _mm_stream_si128((__m128i*)(float_mask_array + block_idx), _mm_set_epi64x((int64_t)f23, (int64_t)f01));
+                block_idx += 2;
+            }
+
+            for (; i + 64 <= len; i += 64) {
+                uint64_t alt_mask, float_mask;
+                uint64_t final_mask = resolve(data + i, 64, alt_mask, float_mask);
+                if (Jsonc && retract) retract_edge(mask_array, alt_mask_array, block_idx);
+                store(final_mask, alt_mask, float_mask);
             }
 
-            // Tail handling
+            // Tail (0-63 bytes): classify a zero-padded copy
             if (i < len) {
-                uint32_t final_mask = 0;
-                int j = 0;
-                for (; i < len; ++i, ++j) {
-                     if (j == 32) { mask_array[block_idx++] = final_mask; final_mask = 0; j = 0; }
-                    char c = data[i];
-                    bool is_quote = (c == '"') && ((prev_escapes & 1) == 0);
-                    if (c == '\\') prev_escapes++; else prev_escapes = 0;
-                    if (in_string_mask) {
-                        if (is_quote) { in_string_mask = 0; final_mask |= (1U << j); }
-                    } else {
-                        if (is_quote) { in_string_mask = ~0; final_mask |= (1U << j); }
-                        else if (c=='{'||c=='}'||c=='['||c==']'||c==':'||c==','||c=='/') final_mask |= (1U << j);
-                    }
-                }
-                mask_array[block_idx++] = final_mask;
+                alignas(32) char tail[64] = {};
+                std::memcpy(tail, data + i, len - i);
+                uint64_t alt_mask, float_mask;
+                uint64_t final_mask = resolve(tail, len - i, alt_mask, float_mask);
+                if (Jsonc && retract) retract_edge(mask_array, alt_mask_array, block_idx);
+                store(final_mask, alt_mask, float_mask);
             }
+
+            state.prev_escaped = prev_escaped;
+            state.in_string = in_string_mask;
+            state.prev_scalar = prev_scalar;
+            state.comment = comment;
+            state.comment_edge = comment_edge;
+            _mm_sfence(); // Streamed masks must be visible before another thread reads them
             return block_idx;
         }
 
         // ---------------------------------------------------------------------
         // AVX-512 ENGINE (GOD MODE)
         // ---------------------------------------------------------------------
-        __attribute__((target("avx512f,avx512bw")))
-        inline size_t compute_structural_mask_avx512(const char* data, size_t len, uint32_t* mask_array) {
-            size_t i = 0;
+        // Classification is a fixed handful of instructions per 64 bytes: two VPSHUFB
+        // nibble lookups, or with VBMI a single VPERMI2B over the 128 ASCII entries.
+        // These are two engines so that only the VBMI one is compiled with VBMI
+        // enabled; both hand their classes to Avx512Words.
+
+        // Everything after classification, a word at a time. Its target is a subset
+        // of both engines' targets, so it inlines into either.
+        template<bool UseClmul, bool Jsonc>
+        struct Avx512Words {
+            uint64_t* mask_array;
+            uint64_t* alt_mask_array;
+            uint64_t* float_mask_array;
+            IndexState& state;
             size_t block_idx = 0;
-            uint64_t prev_escapes = 0;
-            uint64_t in_string_mask = 0;
-
-            const __m512i v_slash = _mm512_set1_epi8('\\');
-            const __m512i v_quote = _mm512_set1_epi8('"');
-            const __m512i v_lbra = _mm512_set1_epi8('[');
-            const __m512i v_rbra = _mm512_set1_epi8(']');
-            const __m512i v_lcur = _mm512_set1_epi8('{');
-            const __m512i v_rcur = _mm512_set1_epi8('}');
-            const __m512i v_col = _mm512_set1_epi8(':');
-            const __m512i v_com = _mm512_set1_epi8(',');
+            uint64_t prev_escaped = state.prev_escaped;
+            uint64_t in_string_mask = state.in_string;
+            uint64_t prev_scalar = state.prev_scalar;
+            uint64_t comment = state.comment;
+            uint64_t comment_edge = state.comment_edge;
+            uint64_t retract = 0;       // JSONC: set by strip_comments, see retract_edge
+
+            // Resolves one word of `bytes` valid bytes (zeroed beyond)
+            __attribute__((target("avx512f,avx512bw,pclmul")))
+            TACHYON_FORCE_INLINE void resolve(__m512i chunk, __m512i char_class, size_t bytes) {
+                uint64_t load_mask = bytes == 64 ? ~0ULL : (1ULL << bytes) - 1;
+                uint64_t bs_mask = _mm512_test_epi8_mask(char_class, _mm512_set1_epi8(CLASS_BACKSLASH));
+                uint64_t quote_mask = _mm512_test_epi8_mask(char_class, _mm512_set1_epi8(CLASS_QUOTE));
+                uint64_t struct_mask = _mm512_test_epi8_mask(char_class, _mm512_set1_epi8((char)CLASS_STRUCT));
+                uint64_t scalar_mask = _mm512_testn_epi8_mask(char_class, _mm512_set1_epi8((char)CLASS_NON_SCALAR)) & load_mask;
+
+                uint64_t escaped = find_escaped(bs_mask, prev_escaped);
+                quote_mask &= ~escaped;
+                struct_mask |= find_scalar_starts(scalar_mask, prev_scalar);
+
+                uint64_t p;
+                if constexpr (UseClmul) p = prefix_xor_clmul(quote_mask);
+                else p = prefix_xor(quote_mask);
+                p ^= in_string_mask;
+                if constexpr (Jsonc) {
+                    uint64_t slash = _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('/'));
+                    uint64_t star = _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('*'));
+                    uint64_t newline = _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\n'));
+                    p = strip_comments(struct_mask, quote_mask, p, in_string_mask, slash, star, newline, comment, comment_edge, retract);
+                }
+                in_string_mask = (uint64_t)((int64_t)p >> 63);
+
+                // The carries out of a partial block sit at bit `bytes`, not bit 64
+                if (bytes < 64) {
+                    prev_escaped = (escaped >> bytes) & 1;
+                    prev_scalar = (scalar_mask >> (bytes - 1)) & 1;
+                }
+
+                if (Jsonc && retract) retract_edge(mask_array, alt_mask_array, block_idx);
+                uint64_t final_mask = (struct_mask & ~p) | quote_mask;
+                if (alt_mask_array) {
+                    uint64_t alt_mask = (struct_mask & p) | quote_mask;
+                    alt_mask_array[block_idx] = alt_mask;
+                }
+                if (float_mask_array) {
+                    uint64_t float_mask = _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('.'))
+                                        | _mm512_cmpeq_epi8_mask(_mm512_or_si512(chunk, _mm512_set1_epi8(0x20)), _mm512_set1_epi8('e'));
+                    float_mask_array[block_idx] = float_mask;
+                }
+                mask_array[block_idx++] = final_mask;
+            }
+
+            // Stores the carries back into the stream state; returns the words written
+            size_t finish() {
+                state.prev_escaped = prev_escaped;
+                state.in_string = in_string_mask;
+                state.prev_scalar = prev_scalar;
+                state.comment = comment;
+                state.comment_edge = comment_edge;
+                return block_idx;
+            }
+        };
+
+        template<bool UseClmul = false, bool Jsonc = false>
+        __attribute__((target("avx512f,avx512bw,pclmul")))
+        inline size_t compute_structural_mask_avx512(const char* data, size_t len, uint64_t* mask_array, IndexState& state, uint64_t* alt_mask_array = nullptr, uint64_t* float_mask_array = nullptr) {
+            Avx512Words<UseClmul, Jsonc> words{ mask_array, alt_mask_array, float_mask_array, state };
+            const __m512i v_lo_tbl = _mm512_load_si512(ASM::zmm_table<nibble_lo_table>.v);
+            const __m512i v_hi_tbl = _mm512_load_si512(ASM::zmm_table<nibble_hi_table>.v);
+            const __m512i v_0f = _mm512_set1_epi8(0x0F);
+
+            auto resolve = [&](__m512i chunk, size_t bytes) __attribute__((target("avx512f,avx512bw,pclmul"), always_inline)) {
+                __m512i lo = _mm512_and_si512(chunk, v_0f);
+                __m512i hi = _mm512_and_si512(_mm512_srli_epi16(chunk, 4), v_0f);
+                words.resolve(chunk, _mm512_and_si512(_mm512_shuffle_epi8(v_lo_tbl, lo), _mm512_shuffle_epi8(v_hi_tbl, hi)), bytes);
+            };
 
+            size_t i = 0;
             // Unrolled loop (128 bytes)
             for (; i + 128 <= len; i += 128) {
-                // PART 1
-                {
-                    __m512i chunk = _mm512_loadu_si512(reinterpret_cast<const __m512i*>(data + i));
-
-                    uint64_t bs_mask = _mm512_cmpeq_epi8_mask(chunk, v_slash);
-                    uint64_t quote_mask = _mm512_cmpeq_epi8_mask(chunk, v_quote);
-                    uint64_t struct_mask =
-                        _mm512_cmpeq_epi8_mask(chunk, v_lbra) | _mm512_cmpeq_epi8_mask(chunk, v_rbra) |
-                        _mm512_cmpeq_epi8_mask(chunk, v_lcur) | _mm512_cmpeq_epi8_mask(chunk, v_rcur) |
-                        _mm512_cmpeq_epi8_mask(chunk, v_col) | _mm512_cmpeq_epi8_mask(chunk, v_com);
-
-                    if (TACHYON_UNLIKELY(bs_mask != 0 || prev_escapes > 0)) {
-                        uint64_t real_quote_mask = 0;
-                        const char* c_ptr = data + i;
-                         for(int j=0; j<64; ++j) {
-                             if (c_ptr[j] == '"' && (prev_escapes & 1) == 0) real_quote_mask |= (1ULL << j);
-                             if (c_ptr[j] == '\\') prev_escapes++; else prev_escapes = 0;
-                         }
-                         quote_mask = real_quote_mask;
-                    } else { prev_escapes = 0; }
-
-                    uint64_t p = quote_mask;
-                    p ^= (p << 1); p ^= (p << 2); p ^= (p << 4); p ^= (p << 8); p ^= (p << 16); p ^= (p << 32);
-                    p ^= in_string_mask;
-
-                    uint64_t odd = std::popcount(quote_mask) & 1;
-                    in_string_mask ^= (0 - odd);
-
-                    uint64_t final_mask = (struct_mask & ~p) | quote_mask;
-                    mask_array[block_idx++] = (uint32_t)final_mask;
-                    mask_array[block_idx++] = (uint32_t)(final_mask >> 32);
-                }
-
-                // PART 2
-                {
-                    __m512i chunk = _mm512_loadu_si512(reinterpret_cast<const __m512i*>(data + i + 64));
-
-                    uint64_t bs_mask = _mm512_cmpeq_epi8_mask(chunk, v_slash);
-                    uint64_t quote_mask = _mm512_cmpeq_epi8_mask(chunk, v_quote);
-                    uint64_t struct_mask =
-                        _mm512_cmpeq_epi8_mask(chunk, v_lbra) | _mm512_cmpeq_epi8_mask(chunk, v_rbra) |
-                        _mm512_cmpeq_epi8_mask(chunk, v_lcur) | _mm512_cmpeq_epi8_mask(chunk, v_rcur) |
-                        _mm512_cmpeq_epi8_mask(chunk, v_col) | _mm512_cmpeq_epi8_mask(chunk, v_com);
-
-                    if (TACHYON_UNLIKELY(bs_mask != 0 || prev_escapes > 0)) {
-                        uint64_t real_quote_mask = 0;
-                        const char* c_ptr = data + i + 64;
-                         for(int j=0; j<64; ++j) {
-                             if (c_ptr[j] == '"' && (prev_escapes & 1) == 0) real_quote_mask |= (1ULL << j);
-                             if (c_ptr[j] == '\\') prev_escapes++; else prev_escapes = 0;
-                         }
-                         quote_mask = real_quote_mask;
-                    } else { prev_escapes = 0; }
+                resolve(_mm512_loadu_si512(reinterpret_cast<const __m512i*>(data + i)), 64);
+                resolve(_mm512_loadu_si512(reinterpret_cast<const __m512i*>(data + i + 64)), 64);
+                _mm_prefetch((const char*)(data + i + 1024), _MM_HINT_T0);
+            }
+
+            // Remainder Loop (64 byte blocks)
+            for (; i + 64 <= len; i += 64) {
+                resolve(_mm512_loadu_si512(reinterpret_cast<const __m512i*>(data + i)), 64);
+            }
+
+            // Masked Tail (0-63 bytes)
+            if (i < len) {
+                size_t remaining = len - i;
+                resolve(_mm512_maskz_loadu_epi8((1ULL << remaining) - 1, reinterpret_cast<const void*>(data + i)), remaining);
+            }
+
+            _mm256_zeroupper();
+            return words.finish();
+        }
+
+        // Same loop as above; only the classification (and so the target) differs
+        template<bool UseClmul = false, bool Jsonc = false>
+        __attribute__((target("avx512f,avx512bw,avx512vbmi,pclmul")))
+        inline size_t compute_structural_mask_avx512_vbmi(const char* data, size_t len, uint64_t* mask_array, IndexState& state, uint64_t* alt_mask_array = nullptr, uint64_t* float_mask_array = nullptr) {
+            Avx512Words<UseClmul, Jsonc> words{ mask_array, alt_mask_array, float_mask_array, state };
+            const __m512i v_ascii_lo = _mm512_load_si512(byte_class_table.v);
+            const __m512i v_ascii_hi = _mm512_load_si512(byte_class_table.v + 64);
+
+            // Indexed by the low 7 bits; bytes >= 0x80 are zeroed by the mask
+            auto resolve = [&](__m512i chunk, size_t bytes) __attribute__((target("avx512f,avx512bw,avx512vbmi,pclmul"), always_inline)) {
+                words.resolve(chunk, _mm512_maskz_permutex2var_epi8(~_mm512_movepi8_mask(chunk), v_ascii_lo, chunk, v_ascii_hi), bytes);
+            };
+
+            size_t i = 0;
+            for (; i + 128 <= len; i += 128) {
+                resolve(_mm512_loadu_si512(reinterpret_cast<const __m512i*>(data + i)), 64);
+                resolve(_mm512_loadu_si512(reinterpret_cast<const __m512i*>(data + i + 64)), 64);
+                _mm_prefetch((const char*)(data + i + 1024), _MM_HINT_T0);
+            }
+            for (; i + 64 <= len; i += 64) {
+                resolve(_mm512_loadu_si512(reinterpret_cast<const __m512i*>(data + i)), 64);
+            }
+            if (i < len) {
+                size_t remaining = len - i;
+                resolve(_mm512_maskz_loadu_epi8((1ULL << remaining) - 1, reinterpret_cast<const void*>(data + i)), remaining);
+            }
+
+            _mm256_zeroupper();
+            return words.finish();
+        }
+
+        // ---------------------------------------------------------------------
+        // SSE4.2 ENGINE
+        // ---------------------------------------------------------------------
+        // Same nibble-table classification as AVX2 at 16 bytes per shuffle; four
+        // chunks make up one 64-bit word.
+        template<bool UseClmul = false, bool Jsonc = false>
+        __attribute__((target("sse4.2,popcnt,pclmul")))
+        inline size_t compute_structural_mask_sse42(const char* data, size_t len, uint64_t* mask_array, IndexState& state, uint64_t* alt_mask_array = nullptr, uint64_t* float_mask_array = nullptr) {
+            const __m128i v_lo_tbl = _mm_load_si128(reinterpret_cast<const __m128i*>(nibble_lo_table));
+            const __m128i v_hi_tbl = _mm_load_si128(reinterpret_cast<const __m128i*>(nibble_hi_table));
+            const __m128i v_0f = _mm_set1_epi8(0x0F);
+            const __m128i v_60 = _mm_set1_epi8(0x60);
+            const __m128i v_non_scalar = _mm_set1_epi8((char)CLASS_NON_SCALAR);
+            const __m128i v_20 = _mm_set1_epi8(0x20);
+            const __m128i v_dot = _mm_set1_epi8('.');
+            const __m128i v_e = _mm_set1_epi8('e');
+
+            size_t i = 0;
+            size_t block_idx = 0;
+            uint64_t prev_escaped = state.prev_escaped;
+            uint64_t in_string_mask = state.in_string;
+            uint64_t prev_scalar = state.prev_scalar;
+            uint64_t comment = state.comment;
+            uint64_t comment_edge = state.comment_edge;
+            uint64_t retract = 0;       // JSONC: set by strip_comments, see retract_edge
+
+            auto classify = [&](const char* ptr, uint64_t& struct_mask, uint64_t& quote_mask, uint64_t& bs_mask, uint64_t& scalar_mask, uint64_t& float_mask) __attribute__((target("sse4.2"), always_inline)) {
+                struct_mask = quote_mask = bs_mask = scalar_mask = float_mask = 0;
+                for (int k = 0; k < 4; ++k) {
+                    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + 16 * k));
+                    __m128i lo = _mm_and_si128(chunk, v_0f);
+                    __m128i hi = _mm_and_si128(_mm_srli_epi16(chunk, 4), v_0f);
+                    __m128i char_class = _mm_and_si128(_mm_shuffle_epi8(v_lo_tbl, lo), _mm_shuffle_epi8(v_hi_tbl, hi));
+                    uint64_t s = (uint16_t)_mm_movemask_epi8(_mm_adds_epu8(char_class, v_60));
+                    uint64_t q = (uint16_t)_mm_movemask_epi8(_mm_slli_epi16(char_class, 7));
+                    uint64_t b = (uint16_t)_mm_movemask_epi8(_mm_slli_epi16(char_class, 6));
+                    uint64_t c = (uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(char_class, v_non_scalar), _mm_setzero_si128()));
+                    struct_mask |= s << (16 * k);
+                    quote_mask |= q << (16 * k);
+                    bs_mask |= b << (16 * k);
+                    scalar_mask |= c << (16 * k);
+                    if (float_mask_array) {
+                        __m128i fp = _mm_or_si128(_mm_cmpeq_epi8(chunk, v_dot), _mm_cmpeq_epi8(_mm_or_si128(chunk, v_20), v_e));
+                        float_mask |= (uint64_t)(uint16_t)_mm_movemask_epi8(fp) << (16 * k);
+                    }
+                }
+            };
+
+            // JSONC: '/', '*' and '\n' of a 64-byte word
+            auto comment_chars = [&](const char* ptr, uint64_t& slash, uint64_t& star, uint64_t& newline) __attribute__((target("sse4.2"), always_inline)) {
+                slash = star = newline = 0;
+                for (int k = 0; k < 4; ++k) {
+                    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + 16 * k));
+                    slash |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('/'))) << (16 * k);
+                    star |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('*'))) << (16 * k);
+                    newline |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))) << (16 * k);
+                }
+            };
 
-                    uint64_t p = quote_mask;
-                    p ^= (p << 1); p ^= (p << 2); p ^= (p << 4); p ^= (p << 8); p ^= (p << 16); p ^= (p << 32);
-                    p ^= in_string_mask;
+            auto resolve = [&](const char* ptr, size_t bytes) __attribute__((target("sse4.2,pclmul"), always_inline)) {
+                uint64_t struct_mask, quote_mask, bs_mask, scalar_mask, float_mask;
+                classify(ptr, struct_mask, quote_mask, bs_mask, scalar_mask, float_mask);
+                uint64_t load_mask = bytes == 64 ? ~0ULL : (1ULL << bytes) - 1;
+                uint64_t escaped = find_escaped(bs_mask & load_mask, prev_escaped);
+                struct_mask &= load_mask;
+                scalar_mask &= load_mask;
+                quote_mask &= load_mask & ~escaped;
+                struct_mask |= find_scalar_starts(scalar_mask, prev_scalar);
+
+                uint64_t p;
+                if constexpr (UseClmul) p = prefix_xor_clmul(quote_mask);
+                else p = prefix_xor(quote_mask);
+                p ^= in_string_mask;
+                if constexpr (Jsonc) {
+                    uint64_t slash, star, newline;
+                    comment_chars(ptr, slash, star, newline);
+                    p = strip_comments(struct_mask, quote_mask, p, in_string_mask, slash, star, newline, comment, comment_edge, retract);
+                }
+                in_string_mask = (uint64_t)((int64_t)p >> 63);
 
-                    uint64_t odd = std::popcount(quote_mask) & 1;
-                    in_string_mask ^= (0 - odd);
+                // The carries out of a partial block sit at bit `bytes`, not bit 64
+                if (bytes < 64) {
+                    prev_escaped = (escaped >> bytes) & 1;
+                    prev_scalar = (scalar_mask >> (bytes - 1)) & 1;
+                }
 
-                    uint64_t final_mask = (struct_mask & ~p) | quote_mask;
-                    mask_array[block_idx++] = (uint32_t)final_mask;
-                    mask_array[block_idx++] = (uint32_t)(final_mask >> 32);
+                if (Jsonc && retract) retract_edge(mask_array, alt_mask_array, block_idx);
+                uint64_t final_mask = (struct_mask & ~p) | quote_mask;
+                if (alt_mask_array) {
+                    uint64_t alt_mask = (struct_mask & p) | quote_mask;
+                    alt_mask_array[block_idx] = alt_mask;
                 }
+                if (float_mask_array) {
+                    float_mask &= load_mask;
+                    float_mask_array[block_idx] = float_mask;
+                }
+                mask_array[block_idx++] = final_mask;
+            };
 
+            for (; i + 64 <= len; i += 64) {
+                resolve(data + i, 64);
                 _mm_prefetch((const char*)(data + i + 1024), _MM_HINT_T0);
             }
 
-            // Remainder Loop (64 byte blocks)
-            for (; i + 64 <= len; i += 64) {
-                 __m512i chunk = _mm512_loadu_si512(reinterpret_cast<const __m512i*>(data + i));
-
-                uint64_t bs_mask = _mm512_cmpeq_epi8_mask(chunk, v_slash);
-                uint64_t quote_mask = _mm512_cmpeq_epi8_mask(chunk, v_quote);
-
-                uint64_t struct_mask =
-                    _mm512_cmpeq_epi8_mask(chunk, v_lbra) | _mm512_cmpeq_epi8_mask(chunk, v_rbra) |
-                    _mm512_cmpeq_epi8_mask(chunk, v_lcur) | _mm512_cmpeq_epi8_mask(chunk, v_rcur) |
-                    _mm512_cmpeq_epi8_mask(chunk, v_col) | _mm512_cmpeq_epi8_mask(chunk, v_com);
-
-                if (TACHYON_UNLIKELY(bs_mask != 0 || prev_escapes > 0)) {
-                    uint64_t real_quote_mask = 0;
-                    const char* c_ptr = data + i;
-                     for(int j=0; j<64; ++j) {
-                         if (c_ptr[j] == '"' && (prev_escapes & 1) == 0) real_quote_mask |= (1ULL << j);
-                         if (c_ptr[j] == '\\') prev_escapes++; else prev_escapes = 0;
-                     }
-                     quote_mask = real_quote_mask;
-                } else { prev_escapes = 0; }
+            // Tail (0-63 bytes): classify a zero-padded copy
+            if (i < len) {
+                alignas(16) char tail[64] = {};
+                std::memcpy(tail, data + i, len - i);
+                resolve(tail, len - i);
+            }
+
+            state.prev_escaped = prev_escaped;
+            state.in_string = in_string_mask;
+            state.prev_scalar = prev_scalar;
+            state.comment = comment;
+            state.comment_edge = comment_edge;
+            return block_idx;
+        }
+
+        // ---------------------------------------------------------------------
+        // PORTABLE ENGINE (Scalar / SWAR)
+        // ---------------------------------------------------------------------
+        // For hosts without SSE4.2. Bytes are classified through byte_class_table;
+        // escapes and strings are then resolved on whole 64-bit words, exactly as
+        // in the SIMD engines.
+        template<bool Jsonc = false>
+        inline size_t compute_structural_mask_scalar(const char* data, size_t len, uint64_t* mask_array, IndexState& state, uint64_t* alt_mask_array = nullptr, uint64_t* float_mask_array = nullptr) {
+            size_t block_idx = 0;
+            uint64_t prev_escaped = state.prev_escaped;
+            uint64_t in_string_mask = state.in_string;
+            uint64_t prev_scalar = state.prev_scalar;
+            uint64_t comment = state.comment;
+            uint64_t comment_edge = state.comment_edge;
+            uint64_t retract = 0;       // JSONC: set by strip_comments, see retract_edge
+
+            for (size_t i = 0; i < len; i += 64) {
+                size_t n = std::min<size_t>(64, len - i);
+                uint64_t struct_mask = 0, quote_mask = 0, bs_mask = 0, scalar_mask = 0, float_mask = 0;
+                uint64_t slash = 0, star = 0, newline = 0;
+                for (size_t k = 0; k < n; ++k) {
+                    if constexpr (Jsonc) {
+                        slash |= (uint64_t)(data[i + k] == '/') << k;
+                        star |= (uint64_t)(data[i + k] == '*') << k;
+                        newline |= (uint64_t)(data[i + k] == '\n') << k;
+                    }
+                    uint64_t cls = byte_class_table.v[(unsigned char)data[i + k]];
+                    struct_mask |= (cls >> 5) << k;
+                    quote_mask |= (cls & CLASS_QUOTE) << k;
+                    bs_mask |= ((cls >> 1) & 1) << k;
+                    scalar_mask |= (uint64_t)((cls & CLASS_NON_SCALAR) == 0) << k;
+                    float_mask |= ((cls >> 4) & 1) << k;
+                }
+
+                uint64_t escaped = find_escaped(bs_mask, prev_escaped);
+                quote_mask &= ~escaped;
+                struct_mask |= find_scalar_starts(scalar_mask, prev_scalar);
+                uint64_t p = prefix_xor(quote_mask) ^ in_string_mask;
+                if constexpr (Jsonc) p = strip_comments(struct_mask, quote_mask, p, in_string_mask, slash, star, newline, comment, comment_edge, retract);
+                in_string_mask = (uint64_t)((int64_t)p >> 63);
+
+                if (Jsonc && retract) retract_edge(mask_array, alt_mask_array, block_idx);
+                uint64_t final_mask = (struct_mask & ~p) | quote_mask;
+                if (alt_mask_array) {
+                    uint64_t alt_mask = (struct_mask & p) | quote_mask;
+                    alt_mask_array[block_idx] = alt_mask;
+                }
+                if (float_mask_array) {
+                    float_mask_array[block_idx] = float_mask;
+                }
+                mask_array[block_idx++] = final_mask;
+
+                if (n < 64) {
+                    prev_escaped = (escaped >> n) & 1;
+                    prev_scalar = (scalar_mask >> (n - 1)) & 1;
+                }
+            }
+
+            state.prev_escaped = prev_escaped;
+            state.in_string = in_string_mask;
+            state.prev_scalar = prev_scalar;
+            state.comment = comment;
+            state.comment_edge = comment_edge;
+            return block_idx;
+        }
+
+        template<bool Jsonc>
+        inline MaskFunction select_structural_mask(ISA isa) {
+            bool clmul = g_dispatch.clmul;
+            switch (isa) {
+                case ISA::AVX512:
+                    if (g_dispatch.vbmi) return clmul ? compute_structural_mask_avx512_vbmi<true, Jsonc> : compute_structural_mask_avx512_vbmi<false, Jsonc>;
+                    return clmul ? compute_structural_mask_avx512<true, Jsonc> : compute_structural_mask_avx512<false, Jsonc>;
+                case ISA::AVX2: return clmul ? compute_structural_mask_avx2<true, Jsonc> : compute_structural_mask_avx2<false, Jsonc>;
+                case ISA::SSE42: return clmul ? compute_structural_mask_sse42<true, Jsonc> : compute_structural_mask_sse42<false, Jsonc>;
+                default: return compute_structural_mask_scalar<Jsonc>;
+            }
+        }
+
+        // `jsonc` selects the engines that drop comments while indexing
+        inline MaskFunction select_structural_mask(ISA isa, bool jsonc = false) {
+            return jsonc ? select_structural_mask<true>(isa) : select_structural_mask<false>(isa);
+        }
+
+        // ---------------------------------------------------------------------
+        // TAPE FLATTENING (Bitmask -> Structural Offsets)
+        // ---------------------------------------------------------------------
+        // Both flatteners may write up to 32 entries past the returned count.
+
+        // Eight unconditional tzcnt/blsr steps per word, advance by popcount
+        template<typename Offset>
+        TACHYON_FORCE_INLINE size_t flatten_bitmask_words(const uint64_t* bitmask, size_t blocks, Offset* out) {
+            Offset* start = out;
+            for (size_t b = 0; b < blocks; ++b) {
+                uint64_t w = bitmask[b];
+                if (w == 0) continue;
+                Offset base = (Offset)(b * 64);
+                int cnt = std::popcount(w);
+                for (int k = 0; k < 8; ++k) { out[k] = base + std::countr_zero(w); w &= w - 1; }
+                if (TACHYON_UNLIKELY(cnt > 8)) {
+                    for (int k = 8; k < 16; ++k) { out[k] = base + std::countr_zero(w); w &= w - 1; }
+                    for (int k = 16; k < cnt; ++k) { out[k] = base + std::countr_zero(w); w &= w - 1; }
+                }
+                out += cnt;
+            }
+            return (size_t)(out - start);
+        }
+
+        template<typename Offset>
+        __attribute__((target("bmi,popcnt")))
+        inline size_t flatten_bitmask_bmi(const uint64_t* bitmask, size_t blocks, Offset* out) {
+            return flatten_bitmask_words(bitmask, blocks, out);
+        }
+
+        // Pre-Haswell hosts: same loop, baseline instructions only
+        template<typename Offset>
+        inline size_t flatten_bitmask_scalar(const uint64_t* bitmask, size_t blocks, Offset* out) {
+            return flatten_bitmask_words(bitmask, blocks, out);
+        }
+
+        // AVX-512: compress a vector of 16 lane offsets by each quarter of the mask
+        __attribute__((target("avx512f,popcnt")))
+        inline size_t flatten_bitmask_avx512(const uint64_t* bitmask, size_t blocks, uint32_t* out) {
+            uint32_t* start = out;
+            const __m512i v_iota = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+            const __m512i v_16 = _mm512_set1_epi32(16);
+            for (size_t b = 0; b < blocks; ++b) {
+                uint64_t w = bitmask[b];
+                if (w == 0) continue;
+                __m512i v_idx = _mm512_add_epi32(_mm512_set1_epi32((int)(b * 64)), v_iota);
+                for (int k = 0; k < 4; ++k, w >>= 16, v_idx = _mm512_add_epi32(v_idx, v_16)) {
+                    _mm512_storeu_si512(out, _mm512_maskz_compress_epi32((__mmask16)w, v_idx));
+                    out += std::popcount(w & 0xFFFF);
+                }
+            }
+            _mm256_zeroupper();
+            return (size_t)(out - start);
+        }
+
+        // Wide (64-bit) offsets: eight lanes per byte of the mask
+        __attribute__((target("avx512f,popcnt")))
+        inline size_t flatten_bitmask_avx512(const uint64_t* bitmask, size_t blocks, uint64_t* out) {
+            uint64_t* start = out;
+            const __m512i v_iota = _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7);
+            const __m512i v_8 = _mm512_set1_epi64(8);
+            for (size_t b = 0; b < blocks; ++b) {
+                uint64_t w = bitmask[b];
+                if (w == 0) continue;
+                __m512i v_idx = _mm512_add_epi64(_mm512_set1_epi64((int64_t)(b * 64)), v_iota);
+                for (int k = 0; k < 8; ++k, w >>= 8, v_idx = _mm512_add_epi64(v_idx, v_8)) {
+                    _mm512_storeu_si512(out, _mm512_maskz_compress_epi64((__mmask8)w, v_idx));
+                    out += std::popcount(w & 0xFF);
+                }
+            }
+            _mm256_zeroupper();
+            return (size_t)(out - start);
+        }
+
+        template<typename Offset>
+        inline size_t flatten_bitmask(const uint64_t* bitmask, size_t blocks, Offset* out) {
+            ISA isa = get_isa(Kernel::Tape);
+            if (isa == ISA::AVX512) return flatten_bitmask_avx512(bitmask, blocks, out);
+            if (isa == ISA::AVX2) return flatten_bitmask_bmi(bitmask, blocks, out);
+            return flatten_bitmask_scalar(bitmask, blocks, out);
+        }
+
+        // ---------------------------------------------------------------------
+        // BRACKET DEPTH KERNEL
+        // ---------------------------------------------------------------------
+        // Splits the indexed structurals of a 64-byte word into brackets and
+        // commas, so one word moves the running depth by popcount(open) -
+        // popcount(close) at once. Only a word in which the depth can reach its
+        // target is walked bracket by bracket.
+        struct BracketMasks { uint64_t open, close, comma, slash; };
+
+        struct DepthScan {
+            static constexpr size_t npos = (size_t)-1;
+            size_t close;   // Offset of the bracket that closed depth 1, or npos
+            size_t commas;  // Commas met at depth 1 on the way
+        };
+
+        // Loose byte tests are enough: only indexed structurals survive the AND
+        __attribute__((target("avx2")))
+        inline BracketMasks classify_brackets_avx2(const char* p, uint64_t structural) {
+            uint64_t m[4] = {};
+            for (int k = 0; k < 2; ++k) {
+                __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32 * k));
+                __m256i folded = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));  // '[' -> '{', ']' -> '}'
+                m[0] |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{'))) << (32 * k);
+                m[1] |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}'))) << (32 * k);
+                m[2] |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(','))) << (32 * k);
+                m[3] |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('/'))) << (32 * k);
+            }
+            return { m[0] & structural, m[1] & structural, m[2] & structural, m[3] & structural };
+        }
+
+        __attribute__((target("avx512f,avx512bw")))
+        inline BracketMasks classify_brackets_avx512(const char* p, uint64_t structural) {
+            __m512i chunk = _mm512_loadu_si512(reinterpret_cast<const __m512i*>(p));
+            __m512i folded = _mm512_or_si512(chunk, _mm512_set1_epi8(0x20));
+            return { _mm512_cmpeq_epi8_mask(folded, _mm512_set1_epi8('{')) & structural,
+                     _mm512_cmpeq_epi8_mask(folded, _mm512_set1_epi8('}')) & structural,
+                     _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8(',')) & structural,
+                     _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('/')) & structural };
+        }
+
+        // One character test per structural
+        inline BracketMasks classify_brackets_scalar(const char* p, uint64_t structural) {
+            BracketMasks r{};
+            for (; structural; structural &= structural - 1) {
+                int bit = std::countr_zero(structural);
+                uint64_t b = 1ULL << bit;
+                switch (p[bit]) {
+                    case '{': case '[': r.open |= b; break;
+                    case '}': case ']': r.close |= b; break;
+                    case ',': r.comma |= b; break;
+                    case '/': r.slash |= b; break;
+                    default: break;
+                }
+            }
+            return r;
+        }
+
+        // From byte `from` at nesting `depth` > 0, finds the bracket that brings the
+        // depth to zero. Gives up (close = npos) when the indexed words run out or
+        // a '/' turns up, since brackets inside JSONC comments would miscount; the
+        // caller then walks tokens instead.
+        template<BracketMasks (*Classify)(const char*, uint64_t), bool CountCommas>
+        TACHYON_FORCE_INLINE DepthScan scan_depth_words(const char* base, size_t len, const uint64_t* bitmask, size_t blocks, size_t from, int64_t depth) {
+            // Bulk steps are only exact while the depth stays above the level being watched
+            constexpr int64_t floor = CountCommas ? 1 : 0;
+            size_t commas = 0;
+            uint64_t keep = ~0ULL << (from % 64);
+            for (size_t w = from / 64; w < blocks; ++w, keep = ~0ULL) {
+                uint64_t structural = bitmask[w] & keep;
+                if (!structural) continue;
+
+                const char* p = base + 64 * w;
+                alignas(64) char tail[64];
+                if (TACHYON_UNLIKELY(64 * w + 64 > len)) {
+                    std::memset(tail, 0, 64);
+                    std::memcpy(tail, p, len - 64 * w);
+                    p = tail;
+                }
+                BracketMasks m = Classify(p, structural);
+                if (TACHYON_UNLIKELY(m.slash)) return { DepthScan::npos, commas };
+
+                uint64_t brackets = m.open | m.close;
+                if (!brackets) {
+                    if (CountCommas && depth == 1) commas += std::popcount(m.comma);
+                    continue;
+                }
+                int64_t closes = std::popcount(m.close);
+                if (depth - closes > floor) {
+                    depth += std::popcount(m.open) - closes;
+                    continue;
+                }
+                uint64_t walk = CountCommas ? (brackets | m.comma) : brackets;
+                for (; walk; walk &= walk - 1) {
+                    uint64_t b = walk & (0 - walk);
+                    if (m.open & b) depth++;
+                    else if (m.close & b) {
+                        if (--depth == 0) return { 64 * w + std::countr_zero(walk), commas };
+                    }
+                    else if (depth == 1) commas++;
+                }
+            }
+            return { DepthScan::npos, commas };
+        }
+
+        template<bool CountCommas>
+        __attribute__((target("avx512f,avx512bw,popcnt,bmi")))
+        inline DepthScan scan_depth_avx512(const char* base, size_t len, const uint64_t* bitmask, size_t blocks, size_t from, int64_t depth) {
+            return scan_depth_words<classify_brackets_avx512, CountCommas>(base, len, bitmask, blocks, from, depth);
+        }
+
+        template<bool CountCommas>
+        __attribute__((target("avx2,popcnt,bmi")))
+        inline DepthScan scan_depth_avx2(const char* base, size_t len, const uint64_t* bitmask, size_t blocks, size_t from, int64_t depth) {
+            return scan_depth_words<classify_brackets_avx2, CountCommas>(base, len, bitmask, blocks, from, depth);
+        }
+
+        template<bool CountCommas>
+        inline DepthScan scan_depth(const char* base, size_t len, const uint64_t* bitmask, size_t blocks, size_t from, int64_t depth) {
+            ISA isa = get_isa(Kernel::Size);
+            if (isa == ISA::AVX512) return scan_depth_avx512<CountCommas>(base, len, bitmask, blocks, from, depth);
+            if (isa == ISA::AVX2) return scan_depth_avx2<CountCommas>(base, len, bitmask, blocks, from, depth);
+            return scan_depth_words<classify_brackets_scalar, CountCommas>(base, len, bitmask, blocks, from, depth);
+        }
+
+        // ---------------------------------------------------------------------
+        // GRAMMAR BYTE MASKS (Mode::Titan)
+        // ---------------------------------------------------------------------
+        // The bytes grammar validation tests, one bit per byte of a 64-byte word.
+        // Brackets are told apart by `curly`, `scalar` is find_scalar_starts'
+        // class, digit to exp are the characters of numbers, and `word4` and
+        // `word5` mark where "true" or "null", and "false", are spelled out. Only
+        // tokens of the finished index, bytes of number runs and bytes inside
+        // strings are looked at, so the tests can be loose everywhere else.
+        // Callers pad a short last word with spaces; the literal tests read four
+        // bytes past the word.
+        struct GrammarMasks { uint64_t quote, colon, comma, open, close, curly, backslash, control, digit, zero, minus, plus, dot, exp, scalar, word4, word5; };
+
+        // Two class bytes per ASCII character, a bit per mask in GrammarMasks
+        // order: quote to control, then digit to exp and non-scalar (0x40).
+        // Bytes >= 0x80 carry none, which leaves them scalar.
+        alignas(64) inline constexpr auto grammar_class_table = [] {
+            struct { uint8_t v[2][128] = {}; } t;
+            auto set = [&](int half, unsigned char c, uint8_t bit) { t.v[half][c] |= bit; };
+            set(0, '"', 0x01);
+            set(0, ':', 0x02);
+            set(0, ',', 0x04);
+            for (unsigned char c : {'{', '['}) set(0, c, 0x08);
+            for (unsigned char c : {'}', ']'}) set(0, c, 0x10);
+            for (unsigned char c : {'{', '}'}) set(0, c, 0x20);
+            set(0, '\\', 0x40);
+            for (int c = 0; c < 0x20; ++c) set(0, (unsigned char)c, 0x80);
+            for (unsigned char c = '0'; c <= '9'; ++c) set(1, c, 0x01);
+            set(1, '0', 0x02);
+            set(1, '-', 0x04);
+            set(1, '+', 0x08);
+            set(1, '.', 0x10);
+            for (unsigned char c : {'e', 'E'}) set(1, c, 0x20);
+            for (int c = 0; c < 128; ++c) {
+                if (byte_class_table.v[c] & CLASS_NON_SCALAR) set(1, (unsigned char)c, 0x40);
+            }
+            return t;
+        }();
+
+        // Where "true" or "null" (word4) and "false" (word5) are spelled out:
+        // each byte XORed with the expected one and all ORed, zero on a match
+        __attribute__((target("avx512f,avx512bw")))
+        TACHYON_FORCE_INLINE void classify_literals_avx512(const char* p, __m512i chunk, GrammarMasks& m) {
+            auto at = [p](int k) __attribute__((target("avx512f,avx512bw"), always_inline)) {
+                return _mm512_loadu_si512(reinterpret_cast<const __m512i*>(p + k));
+            };
+            auto differ = [](__m512i acc, __m512i v, char c) __attribute__((target("avx512f,avx512bw"), always_inline)) {
+                return _mm512_ternarylogic_epi64(acc, v, _mm512_set1_epi8(c), 0xF6);  // acc | (v ^ c)
+            };
+            __m512i c1 = at(1), c2 = at(2), c3 = at(3);
+            __m512i t = differ(differ(differ(_mm512_xor_si512(chunk, _mm512_set1_epi8('t')), c1, 'r'), c2, 'u'), c3, 'e');
+            __m512i n = differ(differ(differ(_mm512_xor_si512(chunk, _mm512_set1_epi8('n')), c1, 'u'), c2, 'l'), c3, 'l');
+            __m512i f = differ(differ(differ(differ(_mm512_xor_si512(chunk, _mm512_set1_epi8('f')), c1, 'a'), c2, 'l'), c3, 's'), at(4), 'e');
+            __m512i four = _mm512_min_epu8(t, n);
+            m.word4 = _mm512_testn_epi8_mask(four, four);
+            m.word5 = _mm512_testn_epi8_mask(f, f);
+        }
+
+        __attribute__((target("avx512f,avx512bw")))
+        inline GrammarMasks classify_grammar_avx512(const char* p) {
+            const __m512i v_0f = _mm512_set1_epi8(0x0F);
+            __m512i chunk = _mm512_loadu_si512(reinterpret_cast<const __m512i*>(p));
+            __m512i folded = _mm512_or_si512(chunk, _mm512_set1_epi8(0x20));
+            __m512i lo = _mm512_and_si512(chunk, v_0f);
+            __m512i hi = _mm512_and_si512(_mm512_srli_epi16(chunk, 4), v_0f);
+            __m512i char_class = _mm512_and_si512(_mm512_shuffle_epi8(_mm512_load_si512(ASM::zmm_table<nibble_lo_table>.v), lo),
+                                                  _mm512_shuffle_epi8(_mm512_load_si512(ASM::zmm_table<nibble_hi_table>.v), hi));
+            GrammarMasks m;
+            m.quote = _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('"'));
+            m.colon = _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8(':'));
+            m.comma = _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8(','));
+            m.open = _mm512_cmpeq_epi8_mask(folded, _mm512_set1_epi8('{'));
+            m.close = _mm512_cmpeq_epi8_mask(folded, _mm512_set1_epi8('}'));
+            m.curly = _mm512_test_epi8_mask(chunk, _mm512_set1_epi8(0x20));
+            m.backslash = _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\\'));
+            m.control = _mm512_cmplt_epu8_mask(chunk, _mm512_set1_epi8(0x20));
+            m.digit = _mm512_cmplt_epu8_mask(_mm512_sub_epi8(chunk, _mm512_set1_epi8('0')), _mm512_set1_epi8(10));
+            m.zero = _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('0'));
+            m.minus = _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('-'));
+            m.plus = _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('+'));
+            m.dot = _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('.'));
+            m.exp = _mm512_cmpeq_epi8_mask(folded, _mm512_set1_epi8('e'));
+            m.scalar = _mm512_testn_epi8_mask(char_class, _mm512_set1_epi8((char)CLASS_NON_SCALAR));
+            classify_literals_avx512(p, chunk, m);
+            return m;
+        }
+
+        // The class bytes by VPERMI2B, then a bit-matrix transpose: GF2P8AFFINEQB
+        // with the bytes of a qword as the matrix and single-bit vectors turns
+        // them into eight bytes of one mask each (rows run from the top, hence
+        // the reversed qwords), and a VPERMB gathers each mask into a qword of
+        // its own. Sixteen masks for eight shuffles, not a compare and a KMOV each.
+        __attribute__((target("avx512f,avx512bw,avx512vbmi,gfni")))
+        inline GrammarMasks classify_grammar_avx512_gfni(const char* p) {
+            const __m512i v_reverse = _mm512_set_epi64(0x38393A3B3C3D3E3FLL, 0x3031323334353637LL, 0x28292A2B2C2D2E2FLL, 0x2021222324252627LL,
+                                                       0x18191A1B1C1D1E1FLL, 0x1011121314151617LL, 0x08090A0B0C0D0E0FLL, 0x0001020304050607LL);
+            const __m512i v_gather = _mm512_set_epi64(0x3F372F271F170F07LL, 0x3E362E261E160E06LL, 0x3D352D251D150D05LL, 0x3C342C241C140C04LL,
+                                                      0x3B332B231B130B03LL, 0x3A322A221A120A02LL, 0x3931292119110901LL, 0x3830282018100800LL);
+            const __m512i v_bits = _mm512_set1_epi64((long long)0x8040201008040201ULL);
+            __m512i chunk = _mm512_loadu_si512(reinterpret_cast<const __m512i*>(p));
+            __m512i reversed = _mm512_maskz_permutexvar_epi8(~0ULL, v_reverse, chunk);  // Zero-masked: the plain form merges into an undefined register
+            __mmask64 ascii = ~_mm512_movepi8_mask(reversed);
+            alignas(64) uint64_t planes[16];
+            for (int k = 0; k < 2; ++k) {
+                __m512i classes = _mm512_maskz_permutex2var_epi8(ascii, _mm512_load_si512(grammar_class_table.v[k]), reversed,
+                                                                 _mm512_load_si512(grammar_class_table.v[k] + 64));
+                __m512i bytes = _mm512_gf2p8affine_epi64_epi8(v_bits, classes, 0);
+                _mm512_store_si512(planes + 8 * k, _mm512_maskz_permutexvar_epi8(~0ULL, v_gather, bytes));
+            }
+            GrammarMasks m;
+            m.quote = planes[0];
+            m.colon = planes[1];
+            m.comma = planes[2];
+            m.open = planes[3];
+            m.close = planes[4];
+            m.curly = planes[5];
+            m.backslash = planes[6];
+            m.control = planes[7];
+            m.digit = planes[8];
+            m.zero = planes[9];
+            m.minus = planes[10];
+            m.plus = planes[11];
+            m.dot = planes[12];
+            m.exp = planes[13];
+            m.scalar = ~planes[14];
+            classify_literals_avx512(p, chunk, m);
+            return m;
+        }
+
+        __attribute__((target("avx2")))
+        inline GrammarMasks classify_grammar_avx2(const char* p) {
+            const __m256i v_0f = _mm256_set1_epi8(0x0F);
+            const __m256i v_lo_tbl = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(nibble_lo_table)));
+            const __m256i v_hi_tbl = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(nibble_hi_table)));
+            GrammarMasks m{};
+            for (int k = 0; k < 2; ++k) {
+                const char* q = p + 32 * k;
+                auto at = [q](int i) __attribute__((target("avx2"), always_inline)) {
+                    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(q + i));
+                };
+                __m256i chunk = at(0);
+                __m256i folded = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+                __m256i char_class = _mm256_and_si256(_mm256_shuffle_epi8(v_lo_tbl, _mm256_and_si256(chunk, v_0f)),
+                                                      _mm256_shuffle_epi8(v_hi_tbl, _mm256_and_si256(_mm256_srli_epi16(chunk, 4), v_0f)));
+                auto bits = [k](__m256i v) __attribute__((target("avx2"), always_inline)) {
+                    return (uint64_t)(uint32_t)_mm256_movemask_epi8(v) << (32 * k);
+                };
+                auto eq = [&](__m256i v, char c) __attribute__((target("avx2"), always_inline)) {
+                    return bits(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)));
+                };
+                auto differ = [](__m256i v, char c) __attribute__((target("avx2"), always_inline)) {
+                    return _mm256_xor_si256(v, _mm256_set1_epi8(c));
+                };
+                m.quote |= eq(chunk, '"');
+                m.colon |= eq(chunk, ':');
+                m.comma |= eq(chunk, ',');
+                m.open |= eq(folded, '{');
+                m.close |= eq(folded, '}');
+                m.curly |= bits(_mm256_slli_epi16(chunk, 2));  // 0x20 to the sign bit
+                m.backslash |= eq(chunk, '\\');
+                m.control |= bits(_mm256_cmpeq_epi8(_mm256_min_epu8(chunk, _mm256_set1_epi8(0x1F)), chunk));  // chunk <= 0x1F
+                __m256i digit = _mm256_sub_epi8(chunk, _mm256_set1_epi8('0'));
+                m.digit |= bits(_mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit));  // chunk - '0' <= 9
+                m.zero |= eq(chunk, '0');
+                m.minus |= eq(chunk, '-');
+                m.plus |= eq(chunk, '+');
+                m.dot |= eq(chunk, '.');
+                m.exp |= eq(folded, 'e');
+                m.scalar |= bits(_mm256_cmpeq_epi8(_mm256_and_si256(char_class, _mm256_set1_epi8((char)CLASS_NON_SCALAR)), _mm256_setzero_si256()));
+                __m256i c1 = at(1), c2 = at(2), c3 = at(3);
+                __m256i t = _mm256_or_si256(_mm256_or_si256(differ(chunk, 't'), differ(c1, 'r')), _mm256_or_si256(differ(c2, 'u'), differ(c3, 'e')));
+                __m256i n = _mm256_or_si256(_mm256_or_si256(differ(chunk, 'n'), differ(c1, 'u')), _mm256_or_si256(differ(c2, 'l'), differ(c3, 'l')));
+                __m256i f = _mm256_or_si256(_mm256_or_si256(differ(chunk, 'f'), differ(c1, 'a')), _mm256_or_si256(differ(c2, 'l'), differ(c3, 's')));
+                m.word4 |= bits(_mm256_cmpeq_epi8(_mm256_min_epu8(t, n), _mm256_setzero_si256()));
+                m.word5 |= bits(_mm256_cmpeq_epi8(_mm256_or_si256(f, differ(at(4), 'e')), _mm256_setzero_si256()));
+            }
+            return m;
+        }
+
+        inline GrammarMasks classify_grammar_scalar(const char* p) {
+            GrammarMasks m{};
+            for (int k = 0; k < 64; ++k) {
+                unsigned char c = (unsigned char)p[k];
+                uint64_t b = 1ULL << k;
+                uint8_t a = c < 128 ? grammar_class_table.v[0][c] : 0;
+                uint8_t n = c < 128 ? grammar_class_table.v[1][c] : 0;
+                uint64_t* masks[] = { &m.quote, &m.colon, &m.comma, &m.open, &m.close, &m.curly, &m.backslash, &m.control,
+                                      &m.digit, &m.zero, &m.minus, &m.plus, &m.dot, &m.exp };
+                for (int i = 0; i < 8; ++i) {
+                    if (a & (1 << i)) *masks[i] |= b;
+                }
+                for (int i = 0; i < 6; ++i) {
+                    if (n & (1 << i)) *masks[8 + i] |= b;
+                }
+                if (!(n & 0x40)) m.scalar |= b;
+                if (std::memcmp(p + k, "true", 4) == 0 || std::memcmp(p + k, "null", 4) == 0) m.word4 |= b;
+                if (std::memcmp(p + k, "false", 5) == 0) m.word5 |= b;
+            }
+            return m;
+        }
+
+        // The bytes that cannot follow a backslash: anything but " \ / b f n r t,
+        // and a 'u' without four hex digits after it (read past the word)
+        inline constexpr auto escape_byte_table = [] {
+            struct { uint8_t v[256] = {}; } t;
+            for (unsigned char c : {'"', '\\', '/', 'b', 'f', 'n', 'r', 't'}) t.v[c] = 1;
+            t.v[(unsigned char)'u'] = 2;
+            for (unsigned char c : {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f', 'A', 'B', 'C', 'D', 'E', 'F'}) t.v[c] |= 4;
+            return t;
+        }();
+
+        __attribute__((target("avx512f,avx512bw")))
+        inline uint64_t escape_faults_avx512(const char* p) {
+            auto at = [p](int k) __attribute__((target("avx512f,avx512bw"), always_inline)) {
+                return _mm512_loadu_si512(reinterpret_cast<const __m512i*>(p + k));
+            };
+            auto eq = [](__m512i v, char c) __attribute__((target("avx512f,avx512bw"), always_inline)) {
+                return _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8(c));
+            };
+            auto hex = [](__m512i v) __attribute__((target("avx512f,avx512bw"), always_inline)) {
+                __m512i letter = _mm512_sub_epi8(_mm512_or_si512(v, _mm512_set1_epi8(0x20)), _mm512_set1_epi8('a'));
+                return _mm512_cmplt_epu8_mask(_mm512_sub_epi8(v, _mm512_set1_epi8('0')), _mm512_set1_epi8(10))
+                     | _mm512_cmplt_epu8_mask(letter, _mm512_set1_epi8(6));
+            };
+            __m512i chunk = at(0);
+            uint64_t simple = eq(chunk, '"') | eq(chunk, '\\') | eq(chunk, '/') | eq(chunk, 'b') | eq(chunk, 'f') | eq(chunk, 'n') | eq(chunk, 'r') | eq(chunk, 't');
+            uint64_t unicode = eq(chunk, 'u') & hex(at(1)) & hex(at(2)) & hex(at(3)) & hex(at(4));
+            return ~(simple | unicode);
+        }
+
+        __attribute__((target("avx2")))
+        inline uint64_t escape_faults_avx2(const char* p) {
+            uint64_t ok = 0;
+            for (int k = 0; k < 2; ++k) {
+                const char* q = p + 32 * k;
+                auto at = [q](int i) __attribute__((target("avx2"), always_inline)) {
+                    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(q + i));
+                };
+                auto eq = [](__m256i v, char c) __attribute__((target("avx2"), always_inline)) {
+                    return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(c));
+                };
+                auto hex = [](__m256i v) __attribute__((target("avx2"), always_inline)) {
+                    __m256i digit = _mm256_sub_epi8(v, _mm256_set1_epi8('0'));
+                    __m256i letter = _mm256_sub_epi8(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+                    return _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit),
+                                           _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter));
+                };
+                __m256i chunk = at(0);
+                __m256i simple = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(eq(chunk, '"'), eq(chunk, '\\')), _mm256_or_si256(eq(chunk, '/'), eq(chunk, 'b'))),
+                                                 _mm256_or_si256(_mm256_or_si256(eq(chunk, 'f'), eq(chunk, 'n')), _mm256_or_si256(eq(chunk, 'r'), eq(chunk, 't'))));
+                __m256i unicode = _mm256_and_si256(_mm256_and_si256(eq(chunk, 'u'), hex(at(1))), _mm256_and_si256(_mm256_and_si256(hex(at(2)), hex(at(3))), hex(at(4))));
+                ok |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_or_si256(simple, unicode)) << (32 * k);
+            }
+            return ~ok;
+        }
+
+        inline uint64_t escape_faults_scalar(const char* p) {
+            uint64_t faults = 0;
+            for (int k = 0; k < 64; ++k) {
+                uint8_t e = escape_byte_table.v[(unsigned char)p[k]];
+                bool ok = (e & 1) || ((e & 2) && (escape_byte_table.v[(unsigned char)p[k + 1]] & escape_byte_table.v[(unsigned char)p[k + 2]]
+                                                  & escape_byte_table.v[(unsigned char)p[k + 3]] & escape_byte_table.v[(unsigned char)p[k + 4]] & 4));
+                if (!ok) faults |= 1ULL << k;
+            }
+            return faults;
+        }
+
+        // One class byte per ASCII character for the fused validating index, a
+        // bit per plane: 0x01 quote, 0x02 backslash, 0x04 structural, 0x08
+        // non-scalar, 0x10 number character. The top three bits tell apart the
+        // bytes that share those: brackets 0x20 (with 0x40 when closing, 0x80
+        // when curly), ':' 0x40, ',' 0x80, '/' none; digits 0x20 ('0' with 0x80),
+        // '-' 0x40, '+' 0xC0, 'e' 0x80, '.' none; control characters all three;
+        // the escape letters b f 0x60, n r t 0x40, u 0xC0 and the other hex
+        // letters 0x20. Bytes >= 0x80 carry none, which leaves them scalar.
+        alignas(64) inline constexpr auto grammar_plane_table = [] {
+            enum : uint8_t { Q = 0x01, B = 0x02, S = 0x04, N = 0x08, D = 0x10, X = 0x20, Y = 0x40, Z = 0x80 };
+            struct { uint8_t v[128] = {}; } t;
+            for (int c = 0; c < 0x20; ++c) t.v[c] = X | Y | Z;
+            for (unsigned char c : {'\t', '\n', '\r'}) t.v[c] |= N;
+            t.v[(unsigned char)' '] = N;
+            t.v[(unsigned char)'"'] = Q | N;
+            t.v[(unsigned char)'\\'] = B;
+            t.v[(unsigned char)'{'] = S | N | X | Z;
+            t.v[(unsigned char)'}'] = S | N | X | Y | Z;
+            t.v[(unsigned char)'['] = S | N | X;
+            t.v[(unsigned char)']'] = S | N | X | Y;
+            t.v[(unsigned char)':'] = S | N | Y;
+            t.v[(unsigned char)','] = S | N | Z;
+            t.v[(unsigned char)'/'] = S | N;
+            for (unsigned char c = '1'; c <= '9'; ++c) t.v[c] = D | X;
+            t.v[(unsigned char)'0'] = D | X | Z;
+            t.v[(unsigned char)'-'] = D | Y;
+            t.v[(unsigned char)'+'] = D | Y | Z;
+            t.v[(unsigned char)'.'] = D;
+            for (unsigned char c : {'e', 'E'}) t.v[c] = D | Z;
+            for (unsigned char c : {'a', 'c', 'd', 'A', 'B', 'C', 'D', 'F'}) t.v[c] = X;
+            for (unsigned char c : {'b', 'f'}) t.v[c] = X | Y;
+            for (unsigned char c : {'n', 'r', 't'}) t.v[c] = Y;
+            t.v[(unsigned char)'u'] = Y | Z;
+            return t;
+        }();
+
+        // VPERMT2B indices that turn eight words of class bytes into eight
+        // planes of eight words: three stages, each trading one bit of the
+        // register number for one bit of the byte position, pairs of registers
+        // at a time (the first index of a pair for the lower register)
+        alignas(64) inline constexpr auto plane_transpose_table = [] {
+            struct { uint8_t v[3][2][64] = {}; } t;
+            for (int hi = 0; hi < 2; ++hi) {
+                for (int i = 0; i < 64; ++i) {
+                    int w = i >> 3, q = i & 7;
+                    t.v[0][hi][i] = (uint8_t)(((i & 1) << 6) | (i & ~1) | hi);
+                    t.v[1][hi][i] = (uint8_t)((((i >> 1) & 1) << 6) | (i & ~2) | (hi << 1));
+                    t.v[2][hi][i] = (uint8_t)(((w >> 2) << 6) | (8 * q + 4 * hi + (w & 3)));
+                }
+            }
+            return t;
+        }();
+    }
+
+    struct AlignedDeleter { void operator()(void* p) const { ASM::aligned_free(p); } };
+
+    // -------------------------------------------------------------------------
+    // ARENA (Materialized Nodes)
+    // -------------------------------------------------------------------------
+    // Monotonic bump allocator. Blocks are kept across reset(), which only
+    // rewinds: once a workload has seen its largest document, parsing and
+    // materializing allocate nothing from the heap. Frees are no-ops, and
+    // nothing placed here is destroyed unless it registered a cleanup.
+    class Arena {
+    public:
+        static constexpr size_t MIN_BLOCK = 64 << 10;
+
+        Arena() = default;
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+        ~Arena() { run_cleanups(); }
+
+        void* allocate(size_t size, size_t align) {
+            size_t at = (used + align - 1) & ~(align - 1);
+            if (TACHYON_LIKELY(current < blocks.size() && at + size <= blocks[current].size)) {
+                used = at + size;
+                return blocks[current].data.get() + at;
+            }
+            return allocate_slow(size, align);
+        }
+
+        // Runs `fn(p)` at the next reset() or at destruction, latest first
+        void on_reset(void (*fn)(void*), void* p) { cleanups.push_back({fn, p}); }
+
+        // O(1) plus the registered cleanups: everything allocated so far is invalid afterwards
+        void reset() { run_cleanups(); current = 0; used = 0; }
+
+        // Runs the cleanups, then returns the blocks to the heap
+        void release() { reset(); blocks.clear(); }
+
+        // Runs the registered cleanups now, leaving the memory as it is
+        void run_cleanups() {
+            for (size_t i = cleanups.size(); i-- > 0;) cleanups[i].first(cleanups[i].second);
+            cleanups.clear();
+        }
+
+    private:
+        struct Block {
+            std::unique_ptr<char[], AlignedDeleter> data;
+            size_t size;
+        };
+        std::vector<Block> blocks;
+        size_t current = 0;  // Block being bumped
+        size_t used = 0;     // Bytes used in it
+        std::vector<std::pair<void (*)(void*), void*>> cleanups;
+
+        void* allocate_slow(size_t size, size_t align) {
+            size_t need = size + align;
+            // Next retained block that fits, else a new one at least double the last
+            while (current + 1 < blocks.size()) {
+                if (blocks[++current].size >= need) { used = 0; return allocate(size, align); }
+            }
+            size_t block = std::max({MIN_BLOCK, need, blocks.empty() ? 0 : blocks.back().size * 2});
+            blocks.push_back(Block{std::unique_ptr<char[], AlignedDeleter>(static_cast<char*>(ASM::aligned_alloc(block))), block});
+            current = blocks.size() - 1;
+            used = 0;
+            return allocate(size, align);
+        }
+    };
+
+    // Allocator of materialized containers and strings: from an Arena when it has
+    // one, else from the heap. A copy never inherits the arena, so copying a
+    // value is how it outlives the next parse.
+    template<typename T>
+    struct ArenaAllocator {
+        using value_type = T;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        Arena* arena = nullptr;
+
+        ArenaAllocator() = default;
+        ArenaAllocator(Arena* a) : arena(a) {}
+        template<typename U> ArenaAllocator(const ArenaAllocator<U>& o) : arena(o.arena) {}
+
+        T* allocate(size_t n) {
+            if (arena) return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+            return std::allocator<T>().allocate(n);
+        }
+        void deallocate(T* p, size_t n) {
+            if (!arena) std::allocator<T>().deallocate(p, n);
+        }
+        ArenaAllocator select_on_container_copy_construction() const { return ArenaAllocator(); }
+
+        template<typename U> bool operator==(const ArenaAllocator<U>& o) const { return arena == o.arena; }
+    };
+
+    using String = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+    template<bool UseTape, typename Offset = uint32_t, bool Comments = true>
+    struct BasicCursor;
+
+    // -------------------------------------------------------------------------
+    // SUCCINCT TREE INDEX (Rank/Select + Balanced Parentheses)
+    // -------------------------------------------------------------------------
+    // Optional navigation index layered over Document::bitmask. Token t (the t-th
+    // set bit) owns BP bits 2t and 2t+1:
+    //   { [  ->  ((   opens the container and its first slot
+    //   , :  ->  )(   closes a slot and opens the next
+    //   } ]  ->  ))   closes the last slot and the container
+    //   other tokens (quotes, scalar starts, comments)  ->  ()   a leaf
+    // A container's children are thus its slots (array elements; keys and values
+    // alternating in objects), and the slot opened at BP position p holds the value
+    // starting at token p / 2 + 1. A range min-max tree over the excess answers
+    // find_close, enclose, child and child_count in O(log n) with byte-table
+    // scans inside a leaf; rank/select directories map tokens to byte offsets.
+    // Cost: about 3 bits per token plus ~10% of the bitmask.
+    // Per BP byte (bit 0 first): excess delta, minimum prefix excess and its multiplicity
+    struct BpByte { int8_t delta; int8_t min; uint8_t count; };
+    inline constexpr auto bp_byte_table = [] {
+        struct { BpByte v[256] = {}; } t;
+        for (int b = 0; b < 256; ++b) {
+            int e = 0, m = 9, c = 0;
+            for (int k = 0; k < 8; ++k) {
+                e += ((b >> k) & 1) ? 1 : -1;
+                if (e < m) { m = e; c = 1; }
+                else if (e == m) c++;
+            }
+            t.v[b] = { (int8_t)e, (int8_t)m, (uint8_t)c };
+        }
+        return t;
+    }();
+
+    // Two BP bits per token by its byte: 3 "((", 0 "))", 2 ")(", 1 "()"; 4 marks a possible comment
+    inline constexpr auto bp_code_table = [] {
+        struct { uint8_t v[256] = {}; } t;
+        for (auto& c : t.v) c = 1;
+        for (unsigned char c : {'{', '['}) t.v[c] = 3;
+        for (unsigned char c : {'}', ']'}) t.v[c] = 0;
+        for (unsigned char c : {',', ':'}) t.v[c] = 2;
+        t.v[(unsigned char)'/'] = 4;
+        return t;
+    }();
+
+    struct TreeIndex {
+        static constexpr size_t npos = (size_t)-1;
+        static constexpr size_t BLOCK_BITS = 2048;    // BP bits per min-max leaf
+        static constexpr size_t SELECT_SAMPLE = 4096; // Tokens per select hint
+
+        // Excess delta, minimum prefix excess and its multiplicity over a span of BP bits
+        struct Node { int64_t excess; int64_t min; uint64_t count; };
+        static constexpr int64_t NO_MIN = (int64_t)1 << 62;
+
+        // Rank/select over the structural bitmask
+        const uint64_t* bits = nullptr;
+        size_t words = 0;
+        size_t tokens = 0;
+        std::vector<uint64_t> rank_super;   // Tokens before each 32-word superblock
+        std::vector<uint16_t> rank_block;   // Tokens before each 4-word block, within its superblock
+        std::vector<uint32_t> select_hint;  // Superblock holding token SELECT_SAMPLE * k
+
+        // Balanced parentheses and their min-max tree (leaves at [leaf_base, leaf_base + blocks))
+        std::vector<uint64_t> bp;
+        size_t bp_len = 0;
+        std::vector<int64_t> block_start;   // Excess before each leaf block
+        std::vector<Node> tree;
+        size_t leaf_base = 1;
+
+        void build(const uint64_t* bitmask, size_t bitmask_len, const char* base, size_t len) {
+            bits = bitmask;
+            words = bitmask_len;
+            rank_super.clear();
+            rank_block.clear();
+            select_hint.clear();
+            size_t total = 0;
+            for (size_t w = 0; w < words; ++w) {
+                if (w % 32 == 0) rank_super.push_back(total);
+                if (w % 4 == 0) rank_block.push_back((uint16_t)(total - rank_super.back()));
+                total += std::popcount(bits[w]);
+                while (select_hint.size() * SELECT_SAMPLE < total) select_hint.push_back((uint32_t)(w / 32));
+            }
+            tokens = total;
+
+            // Parentheses, two bits per token. Tokens inside a JSONC comment are leaves.
+            bp_len = 2 * tokens;
+            bp.assign(bp_len / 64 + 1, 0);
+            size_t t = 0, comment_end = 0;
+            uint64_t acc = 0;
+            for (size_t w = 0; w < words; ++w) {
+                for (uint64_t m = bits[w]; m != 0; m &= m - 1) {
+                    size_t off = w * 64 + std::countr_zero(m);
+                    uint64_t code = bp_code_table.v[(unsigned char)base[off]];
+                    if (TACHYON_UNLIKELY(code > 3 || off < comment_end)) {
+                        if (off >= comment_end) comment_end = comment_end_at(base, off, len);
+                        code = 1;
+                    }
+                    acc |= code << (2 * (t % 32));
+                    if (++t % 32 == 0) { bp[t / 32 - 1] = acc; acc = 0; }
+                }
+            }
+            if (t % 32) bp[t / 32] = acc;
+
+            // Min-max tree
+            size_t blocks = std::max<size_t>(1, (bp_len + BLOCK_BITS - 1) / BLOCK_BITS);
+            leaf_base = std::bit_ceil(blocks);
+            tree.assign(2 * leaf_base, Node{ 0, NO_MIN, 0 });
+            block_start.assign(blocks, 0);
+            int64_t e = 0;
+            for (size_t b = 0; b < blocks; ++b) {
+                block_start[b] = e;
+                size_t lo = b * BLOCK_BITS, hi = std::min(bp_len, lo + BLOCK_BITS);
+                int64_t cur = 0;
+                Node n{ 0, NO_MIN, 0 };
+                auto note = [&](int64_t m, uint64_t c) {
+                    if (m < n.min) { n.min = m; n.count = c; }
+                    else if (m == n.min) n.count += c;
+                };
+                for (size_t j = lo; j < hi;) {
+                    if (j % 8 == 0 && j + 8 <= hi) {
+                        const BpByte& bi = bp_byte_table.v[(bp[j / 64] >> (j % 64)) & 0xFF];
+                        note(cur + bi.min, bi.count);
+                        cur += bi.delta;
+                        j += 8;
+                    } else {
+                        cur += is_open(j) ? 1 : -1;
+                        note(cur, 1);
+                        ++j;
+                    }
+                }
+                n.excess = cur;
+                tree[leaf_base + b] = n;
+                e += cur;
+            }
+            for (size_t v = leaf_base - 1; v >= 1; --v) tree[v] = combine(tree[2 * v], tree[2 * v + 1]);
+        }
+
+        // End of the JSONC comment opening at `off`, or off + 1 for a lone '/'
+        static size_t comment_end_at(const char* base, size_t off, size_t len) {
+            if (off + 1 >= len) return off + 1;
+            if (base[off + 1] == '/') {
+                const void* nl = std::memchr(base + off + 2, '\n', len - off - 2);
+                return nl ? (size_t)((const char*)nl - base) : len;
+            }
+            if (base[off + 1] == '*') {
+                size_t close = std::string_view(base + off + 2, len - off - 2).find("*/");
+                return close == std::string_view::npos ? len : off + 2 + close + 2;
+            }
+            return off + 1;
+        }
+
+        static Node combine(const Node& a, const Node& b) {
+            int64_t bm = b.min == NO_MIN ? NO_MIN : a.excess + b.min;
+            Node r{ a.excess + b.excess, std::min(a.min, bm), 0 };
+            r.count = (a.min == r.min ? a.count : 0) + (bm == r.min ? b.count : 0);
+            return r;
+        }
+
+        // ---------------------------------------------------------------------
+        // Rank / select
+        // ---------------------------------------------------------------------
+        // Tokens at byte offsets < pos
+        size_t rank(size_t pos) const {
+            size_t w = pos / 64;
+            if (w >= words) return tokens;
+            size_t r = rank_super[w / 32] + rank_block[w / 4];
+            for (size_t k = w & ~(size_t)3; k < w; ++k) r += std::popcount(bits[k]);
+            return r + std::popcount(bits[w] & ((1ULL << (pos % 64)) - 1));
+        }
+
+        // Byte offset of token t
+        size_t select(size_t t) const {
+            if (t >= tokens) return npos;
+            size_t h = t / SELECT_SAMPLE;
+            auto first = rank_super.begin() + select_hint[h];
+            auto last = h + 1 < select_hint.size() ? rank_super.begin() + select_hint[h + 1] + 1 : rank_super.end();
+            size_t s = (size_t)(std::upper_bound(first, last, (uint64_t)t) - rank_super.begin()) - 1;
+            size_t b = s * 8, b_end = std::min(rank_block.size(), b + 8);
+            while (b + 1 < b_end && rank_super[s] + rank_block[b + 1] <= t) ++b;
+            size_t r = t - rank_super[s] - rank_block[b];
+            for (size_t w = b * 4;; ++w) {
+                size_t c = std::popcount(bits[w]);
+                if (r < c) {
+                    uint64_t m = bits[w];
+                    while (r--) m &= m - 1;
+                    return w * 64 + std::countr_zero(m);
+                }
+                r -= c;
+            }
+        }
+
+        // ---------------------------------------------------------------------
+        // Balanced parentheses
+        // ---------------------------------------------------------------------
+        bool is_open(size_t j) const { return (bp[j / 64] >> (j % 64)) & 1; }
+
+        // Opens minus closes in [0, j]
+        int64_t excess(size_t j) const {
+            size_t b = j / BLOCK_BITS;
+            int64_t e = block_start[b];
+            for (size_t w = b * (BLOCK_BITS / 64); w < j / 64; ++w) e += 2 * (int64_t)std::popcount(bp[w]) - 64;
+            uint64_t m = bp[j / 64] & (~0ULL >> (63 - j % 64));
+            return e + 2 * (int64_t)std::popcount(m) - (int64_t)(j % 64 + 1);
+        }
+
+        size_t find_close(size_t i) const {
+            uint64_t k = 0;
+            return fwd_select(i + 1, excess(i) - 1, k);
+        }
+
+        // Opening position of the parent node, or npos at the root
+        size_t enclose(size_t i) const {
+            int64_t d = excess(i);
+            if (d <= 1) return npos;
+            size_t j = bwd_search(i, d - 2);
+            return j == npos ? 0 : j + 1;
+        }
+
+        size_t next_sibling(size_t i) const {
+            size_t c = find_close(i);
+            return (c != npos && c + 1 < bp_len && is_open(c + 1)) ? c + 1 : npos;
+        }
+
+        // Nodes in the subtree opened at i, itself included
+        size_t subtree_size(size_t i) const {
+            size_t c = find_close(i);
+            return c == npos ? 0 : (c - i + 1) / 2;
+        }
+
+        // Opening position of the k-th child of the node opened at i
+        size_t child(size_t i, size_t k) const {
+            uint64_t kk = k;
+            size_t m = fwd_select(i, excess(i), kk);
+            return (m != npos && m + 1 < bp_len && is_open(m + 1)) ? m + 1 : npos;
+        }
+
+        size_t child_count(size_t i) const {
+            uint64_t k = ~0ULL;
+            fwd_select(i, excess(i), k);
+            return (size_t)(~0ULL - k) - 1;
+        }
+
+        // ---------------------------------------------------------------------
+        // JSON view
+        // ---------------------------------------------------------------------
+        // Node of the container whose bracket is at byte offset `pos`
+        size_t node_at(size_t pos) const { return 2 * rank(pos); }
+
+        // Array elements (object keys and values alternating); an empty container
+        // still has its one (empty) slot.
+        size_t slot_count(size_t node) const {
+            size_t n = child_count(node);
+            return (n == 1 && !is_open(node + 2)) ? 0 : n;
+        }
+
+        // Byte offset of the value in slot k, or npos
+        size_t slot_value(size_t node, size_t k) const {
+            size_t c = child(node, k);
+            if (c == npos || c + 1 >= bp_len || !is_open(c + 1)) return npos;
+            return select(c / 2 + 1);
+        }
+
+    private:
+        // k-th position j >= from with excess(j) == target, as long as the excess
+        // stays >= target until then; npos once it drops below or the BP ends.
+        // `k` is decremented by every match passed over, so starting from ~0
+        // counts the matches before the drop.
+        size_t fwd_select(size_t from, int64_t target, uint64_t& k) const {
+            if (from >= bp_len) return npos;
+            int64_t cur = from ? excess(from - 1) : 0;
+            size_t b = from / BLOCK_BITS;
+            size_t end = std::min(bp_len, (b + 1) * BLOCK_BITS);
+            size_t r = scan_fwd(from, end, cur, target, k);
+            if (r != end) return r;
+
+            // Climb to the first right sibling that holds the answer, then descend
+            size_t v = leaf_base + b;
+            while (true) {
+                if (v == 1) return npos;
+                if (!(v & 1) && !skip(tree[v + 1], cur, target, k)) { v = v + 1; break; }
+                v >>= 1;
+            }
+            while (v < leaf_base) {
+                v *= 2;
+                if (skip(tree[v], cur, target, k)) v++;
+            }
+            size_t lo = (v - leaf_base) * BLOCK_BITS;
+            r = scan_fwd(lo, std::min(bp_len, lo + BLOCK_BITS), cur, target, k);
+            return r == std::min(bp_len, lo + BLOCK_BITS) ? npos : r;
+        }
+
+        // Passes over node n when it neither drops below `target` nor holds the k-th match
+        static bool skip(const Node& n, int64_t& cur, int64_t target, uint64_t& k) {
+            if (n.min == NO_MIN) return true;   // Padding past the last leaf
+            int64_t m = cur + n.min;
+            if (m < target || (m == target && k < n.count)) return false;
+            if (m == target) k -= n.count;
+            cur += n.excess;
+            return true;
+        }
+
+        size_t scan_fwd(size_t j, size_t end, int64_t& cur, int64_t target, uint64_t& k) const {
+            while (j < end) {
+                if (j % 8 == 0 && j + 8 <= end) {
+                    const BpByte& bi = bp_byte_table.v[(bp[j / 64] >> (j % 64)) & 0xFF];
+                    int64_t m = cur + bi.min;
+                    if (m > target || (m == target && k >= bi.count)) {
+                        if (m == target) k -= bi.count;
+                        cur += bi.delta;
+                        j += 8;
+                        continue;
+                    }
+                }
+                cur += is_open(j) ? 1 : -1;
+                if (cur < target) return npos;
+                if (cur == target && k-- == 0) return j;
+                ++j;
+            }
+            return end;
+        }
+
+        // Largest j < i with excess(j) <= target; npos when only the virtual
+        // position before the sequence qualifies
+        size_t bwd_search(size_t i, int64_t target) const {
+            size_t b = i / BLOCK_BITS;
+            size_t r = scan_bwd(i, b * BLOCK_BITS, target);
+            if (r != npos) return r;
+
+            int64_t before = block_start[b];   // Excess just before node v
+            size_t v = leaf_base + b;
+            while (true) {
+                if (v == 1) return npos;
+                if (v & 1) {
+                    const Node& s = tree[v - 1];
+                    before -= s.excess;
+                    if (before + s.min <= target) { v = v - 1; break; }
+                }
+                v >>= 1;
+            }
+            while (v < leaf_base) {
+                int64_t mid = before + tree[2 * v].excess;
+                const Node& rt = tree[2 * v + 1];
+                if (rt.min != NO_MIN && mid + rt.min <= target) { v = 2 * v + 1; before = mid; }
+                else v = 2 * v;
+            }
+            size_t lo = (v - leaf_base) * BLOCK_BITS;
+            return scan_bwd(std::min(bp_len, lo + BLOCK_BITS), lo, target);
+        }
+
+        // Largest j in [lo, i) with excess(j) <= target, walking down from i - 1
+        size_t scan_bwd(size_t i, size_t lo, int64_t target) const {
+            if (i <= lo) return npos;
+            size_t j = i - 1;
+            int64_t cur = excess(j);
+            while (true) {
+                if (j % 8 == 7 && j >= lo + 7) {
+                    const BpByte& bi = bp_byte_table.v[(bp[j / 64] >> (j % 64 - 7)) & 0xFF];
+                    int64_t before = cur - bi.delta;
+                    if (before + bi.min > target) {
+                        if (j < lo + 8) return npos;
+                        cur = before;
+                        j -= 8;
+                        continue;
+                    }
+                }
+                if (cur <= target) return j;
+                if (j == lo) return npos;
+                cur -= is_open(j) ? 1 : -1;
+                --j;
+            }
+        }
+    };
+
+    // -------------------------------------------------------------------------
+    // GRAMMAR VALIDATION (Mode::Titan)
+    // -------------------------------------------------------------------------
+    // Bit-parallel over the structural index, a 64-byte word at a time while the
+    // window is still in cache. Every rule of the JSON grammar is a rule about
+    // the token before a token and the kind of container it sits in:
+    //  - Adding x << 1 to the gaps between tokens carries each bit of x to the
+    //    next token (follows). Two such sets tell apart the classes a token can
+    //    follow, two more chain key, closing quote and colon.
+    //  - A walk over the brackets of a word, with the open containers as a bit
+    //    stack in a register, yields the kind after each bracket; one more add
+    //    spreads it over the bytes up to the next.
+    // Number runs get the same treatment byte by byte. Literals and escape
+    // sequences are matched in SIMD at every byte and only looked up where one
+    // starts. The index pairs every string's quotes, so a string is just its two
+    // tokens and the bytes between them. `error` is the byte offset of the first
+    // violation: the offending token, the start of a malformed number or literal
+    // (the byte after one that only continues it), the backslash of a bad
+    // escape, the end of input for an unclosed container, the opening quote for
+    // an unterminated string.
+    namespace Grammar {
+        // a + b + carry (0/1), with the carry out left in `carry`
+        TACHYON_FORCE_INLINE uint64_t add(uint64_t a, uint64_t b, uint64_t& carry) {
+            uint64_t sum;
+            bool out = __builtin_add_overflow(a, b, &sum);
+            out |= __builtin_add_overflow(sum, carry, &sum);
+            carry = out;
+            return sum;
+        }
+    }
+
+    struct Validator {
+        static constexpr size_t npos = (size_t)-1;
+
+        size_t error = npos;
+
+        // Checks words [first, first + count) of `words`
+        bool feed(const char* base, size_t len, const uint64_t* words, size_t first, size_t count) {
+            ISA isa = get_isa(Kernel::Utf8);
+            bool clmul = g_dispatch.clmul;
+            if (isa == ISA::AVX512) {
+                if (g_dispatch.gfni) return clmul ? feed_avx512_gfni<true>(base, len, words, first, count) : feed_avx512_gfni<false>(base, len, words, first, count);
+                return clmul ? feed_avx512<true>(base, len, words, first, count) : feed_avx512<false>(base, len, words, first, count);
+            }
+            if (isa == ISA::AVX2) return clmul ? feed_avx2<true>(base, len, words, first, count) : feed_avx2<false>(base, len, words, first, count);
+            return feed_words<SIMD::classify_grammar_scalar, SIMD::escape_faults_scalar, false>(base, len, words, first, count);
+        }
+
+        // After the last window: exactly one complete value
+        bool finish(const char* base, size_t len, const uint64_t* words, size_t blocks) {
+            if (in_string && escape_carry) {
+                error = len - 1;  // A backslash with nothing left to escape
+            } else if (in_string) {
+                // Nothing inside the string is a token: the last one opened it
+                while (blocks > 0 && words[blocks - 1] == 0) --blocks;
+                error = 64 * blocks - 1 - std::countl_zero(words[blocks - 1]);
+            } else if ((prev_run >> 63) && !(prev_digits >> 63)) {
+                error = number_error(base, len, false);
+            } else if (root != RootDone || level != 0 || !spilled.empty()) {
+                error = len;
+            } else {
+                return true;
+            }
+            return false;
+        }
+
+        // Indexes and checks the `n` bytes at `at` in one pass, eight words at a
+        // time with every mask a 512-bit number: adds carry across the words and
+        // shifts take the top bit of the word before. Writes the same words (and
+        // `floats`, if given) as the indexing engines; false when the window may
+        // hold an error, which leaves `state` and the automaton as they were for
+        // index_fn and feed() to redo the window and find it. Needs more than
+        // 64 bytes readable past any block it reads in place.
+        __attribute__((target("avx512f,avx512bw,avx512dq,avx512vbmi,avx512vbmi2,gfni,vpclmulqdq,pclmul,popcnt,bmi,bmi2")))
+        bool index_avx512(const char* data, size_t len, size_t at, size_t n, uint64_t* words, uint64_t* floats, SIMD::IndexState& state) {
+            const __m512i ones = _mm512_set1_epi64(-1);
+            const __m512i zero = _mm512_setzero_si512();
+            const __m512i v_bits = _mm512_set1_epi64((long long)0x8040201008040201ULL);
+            const __m512i v_even = _mm512_set1_epi64(0x5555555555555555LL);
+            const __m512i v_table_lo = _mm512_load_si512(SIMD::grammar_plane_table.v);
+            const __m512i v_table_hi = _mm512_load_si512(SIMD::grammar_plane_table.v + 64);
+            auto lane7 = [](uint64_t x) __attribute__((target("avx512f"), always_inline)) {
+                return _mm512_maskz_set1_epi64(0x80, (long long)x);
+            };
+            auto top = [](__m512i x) __attribute__((target("avx512f"), always_inline)) {
+                return (uint64_t)_mm256_extract_epi64(_mm512_maskz_extracti64x4_epi64(0xF, x, 1), 3);
+            };
+            // x << 1 with the top bit of `prev`'s last word shifted in
+            auto shl = [](__m512i x, __m512i prev) __attribute__((target("avx512f,avx512vbmi2"), always_inline)) {
+                return _mm512_shldi_epi64(x, _mm512_maskz_alignr_epi64(0xFF, x, prev, 7), 1);
+            };
+            // a + b + carry, with the carries between the words looked ahead in a GPR
+            auto add = [&](__m512i a, __m512i b, uint64_t& carry) __attribute__((target("avx512f,avx512bw,avx512dq"), always_inline)) {
+                __m512i sum = _mm512_add_epi64(a, b);
+                uint32_t generate = _mm512_cmplt_epu64_mask(sum, a);
+                uint32_t propagate = _mm512_cmpeq_epi64_mask(sum, ones);
+                uint32_t carries = ((generate << 1) | (uint32_t)carry) + propagate;
+                carry = carries >> 8;
+                return _mm512_mask_sub_epi64(sum, (__mmask8)((carries ^ propagate) & 0xFF), sum, ones);
+            };
+
+            // Leaving a precise window, a literal may still be owed its next byte
+            for (uint64_t owed = literal_carry; owed != 0; owed &= owed - 1) {
+                size_t k = at + std::countr_zero(owed);
+                if (k < len && !(SIMD::byte_class_table.v[(unsigned char)data[k]] & SIMD::CLASS_NON_SCALAR)) return false;
+            }
+
+            const uint8_t entry_root = root;
+            uint64_t escape = state.prev_escaped, inside_carry = state.in_string;
+            uint64_t st = stack;
+            int64_t lv = level;
+            uint64_t object_carry = in_object & 1;
+            uint64_t c[4] = { follow_carry[0], follow_carry[1], follow_carry[2], follow_carry[3] };
+            uint64_t run_c = run_carry, dot_c = dot_carry, exp_c = exp_carry, owed = 0;
+            __m512i prev_nonscalar = lane7(state.prev_scalar ? 0 : ~0ULL), prev_kind = lane7(in_object);
+            __m512i prev_run_v = lane7(prev_run), prev_digits_v = lane7(prev_digits), prev_exps_v = lane7(prev_exps);
+            __m512i prev_minus_v = lane7(prev_minus_starts), prev_zeros_v = lane7(prev_lead_zeros);
+            uint64_t flagged = 0;
+
+            for (size_t pos = at; pos < at + n; pos += 512) {
+                size_t count = std::min<size_t>(8, (at + n - pos + 63) / 64);
+                const char* p = data + pos;
+                owed = 0;
+                alignas(64) char tail[640];
+                if (pos + 576 > len) {
+                    std::memset(tail, ' ', sizeof(tail));
+                    std::memcpy(tail, p, std::min(len - pos, sizeof(tail)));
+                    p = tail;
+                }
+
+                // Class bytes, then planes: the bytes of each qword become one
+                // byte per plane (bit-matrix transposes, rows reversed), three
+                // stages of VPERMT2B gather each plane into a register of its own
+                // and a last affine restores the bit order
+                __m512i r[8];
+                for (int w = 0; w < 8; ++w) {
+                    __m512i chunk = _mm512_loadu_si512(reinterpret_cast<const __m512i*>(p + 64 * w));
+                    __m512i classes = _mm512_maskz_permutex2var_epi8(~_mm512_movepi8_mask(chunk), v_table_lo, chunk, v_table_hi);
+                    r[w] = _mm512_gf2p8affine_epi64_epi8(v_bits, classes, 0);
+                }
+                auto trade = [](__m512i& a, __m512i& b, const uint8_t (&index)[2][64]) __attribute__((target("avx512f,avx512vbmi"), always_inline)) {
+                    __m512i lo = _mm512_permutex2var_epi8(a, _mm512_load_si512(index[0]), b);
+                    b = _mm512_permutex2var_epi8(a, _mm512_load_si512(index[1]), b);
+                    a = lo;
+                };
+                const auto& stages = SIMD::plane_transpose_table.v;
+                trade(r[0], r[1], stages[0]); trade(r[2], r[3], stages[0]); trade(r[4], r[5], stages[0]); trade(r[6], r[7], stages[0]);
+                trade(r[0], r[2], stages[1]); trade(r[1], r[3], stages[1]); trade(r[4], r[6], stages[1]); trade(r[5], r[7], stages[1]);
+                trade(r[0], r[4], stages[2]); trade(r[1], r[5], stages[2]); trade(r[2], r[6], stages[2]); trade(r[3], r[7], stages[2]);
+                for (int w = 0; w < 8; ++w) r[w] = _mm512_gf2p8affine_epi64_epi8(r[w], v_bits, 0);
+                const __m512i quote = r[0], backslash = r[1], structural = r[2], nonscalar = r[3];
+                const __m512i number = r[4], x5 = r[5], x6 = r[6], x7 = r[7];
+
+                // The index: find_escaped, find_scalar_starts and the prefix XOR
+                // per 128-bit lane, with the parity of the words before folded in
+                __m512i escaped = zero;
+                bool escapes = (_mm512_test_epi64_mask(backslash, backslash) | escape) != 0;
+                if (escapes) {
+                    __m512i first = _mm512_maskz_set1_epi64(1, (long long)escape);
+                    __m512i bs = _mm512_maskz_andnot_epi64(0xFF, first, backslash);
+                    __m512i follows_escape = _mm512_or_si512(shl(bs, zero), first);
+                    __m512i odd_starts = _mm512_ternarylogic_epi64(bs, v_even, follows_escape, 0x10);  // a & ~b & ~c
+                    escape = 0;
+                    __m512i even_runs = add(odd_starts, bs, escape);
+                    escaped = _mm512_ternarylogic_epi64(v_even, shl(even_runs, zero), follows_escape, 0x28);  // (a ^ b) & c
+                }
+                __m512i quotes = _mm512_maskz_andnot_epi64(0xFF, escaped, quote);
+                __m512i starts_all = _mm512_maskz_andnot_epi64(0xFF, nonscalar, shl(nonscalar, prev_nonscalar));
+                prev_nonscalar = nonscalar;
+                __m512i local = _mm512_maskz_unpacklo_epi64(0xFF, _mm512_clmulepi64_epi128(quotes, ones, 0x00), _mm512_clmulepi64_epi128(quotes, ones, 0x01));
+                uint32_t before = (uint32_t)_mm512_movepi64_mask(local) << 1;
+                before ^= before << 1;
+                before ^= before << 2;
+                before ^= before << 4;
+                before ^= (uint32_t)inside_carry & 0x1FF;
+                __m512i inside = _mm512_mask_xor_epi64(local, (__mmask8)before, local, ones);
+                inside_carry = 0 - (uint64_t)((before >> 8) & 1);
+                __m512i tokens = _mm512_ternarylogic_epi64(_mm512_or_si512(structural, starts_all), inside, quotes, 0xBA);  // (a & ~b) | c
+                _mm512_mask_storeu_epi64(words + pos / 64, (__mmask8)((1u << count) - 1), tokens);
+                if (floats) _mm512_mask_storeu_epi64(floats + pos / 64, (__mmask8)((1u << count) - 1), _mm512_ternarylogic_epi64(number, x5, x6, 0x10));
+
+                // Tokens by class, and the strings' control characters
+                __m512i open_quote = _mm512_and_si512(quotes, inside), close_quote = _mm512_maskz_andnot_epi64(0xFF, inside, quotes);
+                __m512i structurals = _mm512_and_si512(tokens, structural);
+                __m512i open = _mm512_ternarylogic_epi64(structurals, x5, x6, 0x40);  // a & b & ~c
+                __m512i close = _mm512_ternarylogic_epi64(structurals, x5, x6, 0x80);
+                __m512i colon = _mm512_ternarylogic_epi64(structurals, x6, x5, 0x40);
+                __m512i comma = _mm512_ternarylogic_epi64(structurals, x7, x5, 0x40);
+                __m512i brackets = _mm512_and_si512(structurals, x5);
+                __m512i any_x = _mm512_ternarylogic_epi64(x5, x6, x7, 0xFE);
+                __m512i scalar = _mm512_ternarylogic_epi64(tokens, structural, quote, 0x10);
+                __m512i errors = _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(x5, x6, x7, 0x80), structural, inside, 0x20);  // a & ~b & c
+                errors = _mm512_or_si512(errors, _mm512_maskz_andnot_epi64(0xFF, any_x, structurals));  // '/'
+                __m512i starts = _mm512_ternarylogic_epi64(scalar, number, _mm512_ternarylogic_epi64(x5, x6, x7, 0xF4), 0x80);  // digit or '-'
+
+                if (escapes) {
+                    // Escaped bytes no escape sequence starts with; a 'u' needs
+                    // four hex digits, those past the block are looked up below
+                    __m512i hex = _mm512_ternarylogic_epi64(number, _mm512_ternarylogic_epi64(x5, x7, x6, 0xF4), _mm512_ternarylogic_epi64(x5, x7, structural, 0x10),
+                                        0xCA);  // a ? b : c
+                    __m512i unicode = _mm512_maskz_andnot_epi64(0xFF, number, _mm512_ternarylogic_epi64(x6, x7, x5, 0x40));
+                    __m512i letters = _mm512_ternarylogic_epi64(x6, x7, _mm512_or_si512(structural, number), 0x10);
+                    __m512i simple = _mm512_ternarylogic_epi64(_mm512_or_si512(quote, backslash), _mm512_maskz_andnot_epi64(0xFF, any_x, structural), letters, 0xFE);
+                    __m512i next = _mm512_maskz_alignr_epi64(0xFF, ones, hex, 1);
+                    __m512i digits4 = _mm512_ternarylogic_epi64(_mm512_shrdi_epi64(hex, next, 1), _mm512_shrdi_epi64(hex, next, 2), _mm512_shrdi_epi64(hex, next, 3), 0x80);
+                    __m512i good = _mm512_ternarylogic_epi64(simple, _mm512_ternarylogic_epi64(digits4, _mm512_shrdi_epi64(hex, next, 4), unicode, 0x80), zero, 0xFE);
+                    errors = _mm512_ternarylogic_epi64(errors, _mm512_ternarylogic_epi64(escaped, inside, good, 0x40), zero, 0xFE);
+                    for (uint64_t u = top(_mm512_and_si512(escaped, unicode)) >> 60; u != 0; u &= u - 1) {
+                        const char* e = p + 448 + 60 + std::countr_zero(u);
+                        for (int k = 1; k <= 4; ++k) flagged |= !(SIMD::escape_byte_table.v[(unsigned char)e[k]] & 4);
+                    }
+                }
+
+                // Container kinds: the bracket walk a word at a time in GPRs
+                alignas(64) uint64_t bracket_w[8], close_w[8], curly_w[8], literal_w[8], kinds_w[8];
+                alignas(64) uint64_t token_w[8], open_w[8], scalar_w[8], open_quote_w[8];
+                _mm512_store_si512(bracket_w, brackets);
+                _mm512_store_si512(close_w, close);
+                _mm512_store_si512(curly_w, x7);
+                _mm512_store_si512(literal_w, _mm512_maskz_andnot_epi64(0xFF, starts, scalar));
+                bool spelled = false;
+                auto spell = [&] {
+                    if (spelled) return;
+                    spelled = true;
+                    _mm512_store_si512(token_w, tokens);
+                    _mm512_store_si512(open_w, open);
+                    _mm512_store_si512(scalar_w, scalar);
+                    _mm512_store_si512(open_quote_w, open_quote);
+                };
+                for (int w = 0; w < 8; ++w) {
+                    uint64_t b = bracket_w[w], cl = close_w[w], cu = curly_w[w], kinds = 0;
+                    if (TACHYON_UNLIKELY(root != RootContainer)) {
+                        spell();
+                        flagged |= settle_root(token_w[w], open_w[w], cl, scalar_w[w], open_quote_w[w]);
+                    }
+                    int64_t shuts = std::popcount(cl), opens = std::popcount(b) - shuts;
+                    if (TACHYON_LIKELY(lv > shuts && lv + opens < 64)) {
+                        for (; b != 0; b &= b - 1) {
+                            int k = std::countr_zero(b);
+                            uint64_t pushed = (st << 1) | ((cu >> k) & 1);
+                            st = (cl >> k) & 1 ? st >> 1 : pushed;
+                            kinds |= (st & 1) << k;
+                        }
+                        lv += opens - shuts;
+                    } else {
+                        for (; b != 0; b &= b - 1) {
+                            int k = std::countr_zero(b);
+                            uint64_t shut = (cl >> k) & 1;
+                            st = shut ? st >> 1 : (st << 1) | ((cu >> k) & 1);
+                            lv += shut ? -1 : 1;
+                            if ((uint64_t)(lv - 1) >= 63) {
+                                // Only the register: spills and reloads are left to feed()
+                                if (lv == 64 || !spilled.empty()) { root = entry_root; return false; }
+                                spell();
+                                Rebalanced rb = rebalance(st, lv, k, token_w[w]);
+                                st = rb.stack;
+                                lv = rb.level;
+                                flagged |= rb.errors;
+                            }
+                            kinds |= (st & 1) << k;
+                        }
+                    }
+                    kinds_w[w] = kinds;
+
+                    // Literals: spelled out, no scalar byte after
+                    for (uint64_t l = literal_w[w]; l != 0; l &= l - 1) {
+                        int k = std::countr_zero(l);
+                        uint64_t v;
+                        std::memcpy(&v, p + 64 * w + k, 8);
+                        int length = ((uint32_t)v == 0x65757274 || (uint32_t)v == 0x6C6C756E) ? 4 : (v & 0xFFFFFFFFFFULL) == 0x65736C6166ULL ? 5 : 0;
+                        flagged |= length == 0 || !(SIMD::byte_class_table.v[(unsigned char)p[64 * w + k + length]] & SIMD::CLASS_NON_SCALAR);
+                        if (w == 7 && k + length >= 64) owed |= 1ULL << (k + length - 64);
+                    }
+                }
+                __m512i kinds = _mm512_load_si512(kinds_w);
+                __m512i between = _mm512_xor_si512(brackets, ones);
+                __m512i kind = _mm512_ternarylogic_epi64(kinds, add(between, shl(kinds, zero), object_carry), between, 0xF2);  // a | (~b & c)
+                object_carry = top(kind) >> 63;
+                __m512i object = shl(kind, prev_kind);
+                prev_kind = kind;
+
+                // The class of the token before each token, as in feed()
+                __m512i gaps = _mm512_xor_si512(tokens, ones);
+                auto follows = [&](__m512i x, uint64_t& carry) __attribute__((target("avx512f,avx512bw,avx512dq,avx512vbmi2"), always_inline)) {
+                    uint64_t in = carry;
+                    __m512i sum = add(gaps, shl(x, zero), in);
+                    carry = in | (top(x) >> 63);
+                    return _mm512_and_si512(sum, tokens);
+                };
+                __m512i opened = follows(_mm512_or_si512(open, comma), c[0]);
+                __m512i valued = follows(_mm512_ternarylogic_epi64(comma, close, _mm512_ternarylogic_epi64(scalar, close_quote, zero, 0xFE), 0xFE), c[1]);
+                __m512i key_close = follows(_mm512_ternarylogic_epi64(open_quote, opened, object, 0x80), c[2]);
+                __m512i colon_due = follows(key_close, c[3]);
+                errors = _mm512_ternarylogic_epi64(errors, _mm512_ternarylogic_epi64(open_quote, valued, opened, 0x40),
+                               _mm512_maskz_andnot_epi64(0xFF, _mm512_ternarylogic_epi64(opened, object, valued, 0x35), _mm512_or_si512(open, scalar)), 0xFE);
+                errors = _mm512_ternarylogic_epi64(errors, _mm512_ternarylogic_epi64(close, _mm512_xor_si512(x7, object), _mm512_xor_si512(opened, valued), 0xD0),  // a & (b | ~c)
+                               _mm512_ternarylogic_epi64(comma, valued, opened, 0xB0), 0xFE);  // a & ~(b & ~c)
+                errors = _mm512_ternarylogic_epi64(errors, colon, colon_due, 0xF6);  // a | (b ^ c)
+
+                // Numbers, as in feed()
+                __m512i run = _mm512_maskz_andnot_epi64(0xFF, add(number, starts, run_c), number);
+                __m512i digits = _mm512_and_si512(run, x5);
+                __m512i exps = _mm512_ternarylogic_epi64(run, x7, _mm512_or_si512(x5, x6), 0x40);
+                __m512i dots = _mm512_maskz_andnot_epi64(0xFF, any_x, run);
+                __m512i after_digit = shl(digits, prev_digits_v);
+                __m512i after_exp = shl(exps, prev_exps_v);
+                __m512i minus_starts = _mm512_and_si512(starts, x6);
+                __m512i lead_zeros = _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(run, x5, x7, 0x80), starts, shl(minus_starts, prev_minus_v), 0xE0);  // a & (b | c)
+                __m512i after_run = _mm512_maskz_andnot_epi64(0xFF, run, shl(run, prev_run_v));
+                __m512i past_exp = add(run, exps, exp_c);
+                __m512i dot_sum = add(run, dots, dot_c);
+                __m512i numbers = _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(_mm512_and_si512(run, x6), starts, after_exp, 0x10),
+                                        _mm512_ternarylogic_epi64(dots, exps, after_digit, 0x54),  // (a | b) & ~c
+                                        _mm512_and_si512(digits, shl(lead_zeros, prev_zeros_v)), 0xFE);
+                numbers = _mm512_ternarylogic_epi64(numbers, _mm512_ternarylogic_epi64(dots, dot_sum, past_exp, 0xD0), _mm512_and_si512(exps, past_exp), 0xFE);
+                numbers = _mm512_ternarylogic_epi64(numbers, after_run, _mm512_and_si512(after_digit, nonscalar), 0xF4);  // a | (b & ~c)
+                prev_run_v = run;
+                prev_digits_v = digits;
+                prev_exps_v = exps;
+                prev_minus_v = minus_starts;
+                prev_zeros_v = lead_zeros;
+
+                __m512i any_error = _mm512_or_si512(errors, numbers);
+                if (TACHYON_UNLIKELY(flagged != 0 || _mm512_test_epi64_mask(any_error, any_error) != 0)) {
+                    root = entry_root;
+                    return false;
+                }
+            }
+
+            state.prev_escaped = escape;
+            state.in_string = inside_carry;
+            state.prev_scalar = ~top(prev_nonscalar) >> 63;
+            escape_carry = escape;
+            in_string = inside_carry;
+            stack = st;
+            level = lv;
+            in_object = 0 - object_carry;
+            for (int k = 0; k < 4; ++k) follow_carry[k] = c[k];
+            run_carry = run_c;
+            dot_carry = dot_c;
+            exp_carry = exp_c;
+            literal_carry = owed;
+            prev_run = top(prev_run_v);
+            prev_digits = top(prev_digits_v);
+            prev_exps = top(prev_exps_v);
+            prev_minus_starts = top(prev_minus_v);
+            prev_lead_zeros = top(prev_zeros_v);
+            _mm256_zeroupper();
+            return true;
+        }
+
+    private:
+        enum : uint8_t { RootValue, RootString, RootContainer, RootDone };
+
+        uint8_t root = RootValue;
+        uint64_t in_string = 0;
+        uint64_t escape_carry = 0;  // The next word's first byte is escaped (0/1)
+        uint64_t in_object = 0;     // Kind after the last bracket: ~0 in an object
+        uint64_t stack = 0;         // Kinds of the open containers, innermost in bit 0 (1 for an object)
+        int64_t level = 0;          // How many of them `stack` holds; the deeper ones are spilled
+        std::vector<uint64_t> spilled;
+        uint64_t follow_carry[4] = { 1, 0, 0, 0 };  // The first token follows a virtual '['
+        uint64_t run_carry = 0, dot_carry = 0, exp_carry = 0, literal_carry = 0;
+        uint64_t prev_run = 0, prev_digits = 0, prev_exps = 0, prev_minus_starts = 0, prev_lead_zeros = 0;
+
+        template<bool UseClmul>
+        __attribute__((target("avx512f,avx512bw,pclmul,popcnt,bmi")))
+        bool feed_avx512(const char* base, size_t len, const uint64_t* words, size_t first, size_t count) {
+            bool ok = feed_words<SIMD::classify_grammar_avx512, SIMD::escape_faults_avx512, UseClmul>(base, len, words, first, count);
+            _mm256_zeroupper();
+            return ok;
+        }
+
+        template<bool UseClmul>
+        __attribute__((target("avx512f,avx512bw,avx512vbmi,gfni,pclmul,popcnt,bmi")))
+        bool feed_avx512_gfni(const char* base, size_t len, const uint64_t* words, size_t first, size_t count) {
+            bool ok = feed_words<SIMD::classify_grammar_avx512_gfni, SIMD::escape_faults_avx512, UseClmul>(base, len, words, first, count);
+            _mm256_zeroupper();
+            return ok;
+        }
+
+        template<bool UseClmul>
+        __attribute__((target("avx2,pclmul,popcnt,bmi")))
+        bool feed_avx2(const char* base, size_t len, const uint64_t* words, size_t first, size_t count) {
+            return feed_words<SIMD::classify_grammar_avx2, SIMD::escape_faults_avx2, UseClmul>(base, len, words, first, count);
+        }
+
+        template<SIMD::GrammarMasks (*Classify)(const char*), uint64_t (*Faults)(const char*), bool UseClmul>
+        TACHYON_FORCE_INLINE bool feed_words(const char* base, size_t len, const uint64_t* words, size_t first, size_t count) {
+            size_t bad = npos;
+            uint64_t st = stack;
+            int64_t lv = level;
+            uint64_t c[4] = { follow_carry[0], follow_carry[1], follow_carry[2], follow_carry[3] };
+            for (size_t w = first; w < first + count; ++w) {
+                const char* p = base + 64 * w;
+                alignas(64) char tail[128];
+                if (TACHYON_UNLIKELY(64 * w + 68 > len)) {
+                    std::memset(tail, ' ', sizeof(tail));
+                    std::memcpy(tail, p, std::min(len - 64 * w, sizeof(tail)));
+                    p = tail;
+                }
+                SIMD::GrammarMasks m = Classify(p);
+                uint64_t tokens = words[w];
+
+                // Strings: a quote token opens one exactly when it is inside. No
+                // control character inside, and every backslash starts an escape
+                uint64_t quotes = tokens & m.quote;
+                uint64_t inside;
+                if constexpr (UseClmul) inside = SIMD::prefix_xor_clmul(quotes) ^ in_string;
+                else inside = SIMD::prefix_xor(quotes) ^ in_string;
+                in_string = (uint64_t)((int64_t)inside >> 63);
+                uint64_t open_quote = quotes & inside;
+                uint64_t close_quote = quotes & ~inside;
+                uint64_t errors = m.control & inside;
+                uint64_t faults = 0;  // Escaped bytes no escape sequence starts with
+                if ((m.backslash | escape_carry) != 0) faults = SIMD::find_escaped(m.backslash, escape_carry) & inside & Faults(p);
+
+                uint64_t open = tokens & m.open, close = tokens & m.close;
+                uint64_t colon = tokens & m.colon, comma = tokens & m.comma;
+                uint64_t scalar = tokens & ~(quotes | open | close | colon | comma);  // A lone '/' fails as a literal
+                if (TACHYON_UNLIKELY(root != RootContainer)) errors |= settle_root(tokens, open, close, scalar, open_quote);
+
+                // Container kinds: the kind after each bracket, then over the bytes
+                // up to the next one the kind each byte sits in. Unless the word may
+                // close the root or overflow the register, the walk checks neither.
+                uint64_t brackets = open | close;
+                uint64_t kinds = 0;
+                int64_t opens = std::popcount(open), shuts = std::popcount(close);
+                if (TACHYON_LIKELY(lv > shuts && lv + opens < 64)) {
+                    for (uint64_t b = brackets; b != 0; b &= b - 1) {
+                        int at = std::countr_zero(b);
+                        uint64_t pushed = (st << 1) | ((m.curly >> at) & 1);
+                        st = (close >> at) & 1 ? st >> 1 : pushed;
+                        kinds |= (st & 1) << at;
+                    }
+                    lv += opens - shuts;
+                } else {
+                    for (uint64_t b = brackets; b != 0; b &= b - 1) {
+                        int at = std::countr_zero(b);
+                        uint64_t shut = (close >> at) & 1;
+                        st = shut ? st >> 1 : (st << 1) | ((m.curly >> at) & 1);
+                        lv += shut ? -1 : 1;
+                        if ((uint64_t)(lv - 1) >= 63) {
+                            Rebalanced r = rebalance(st, lv, at, tokens);
+                            st = r.stack;
+                            lv = r.level;
+                            errors |= r.errors;
+                        }
+                        kinds |= (st & 1) << at;
+                    }
+                }
+                uint64_t between = ~brackets;
+                uint64_t kind = kinds | (((between + (kinds << 1)) ^ between) & between) | (in_object & between & (brackets - 1));
+                uint64_t object = (kind << 1) | (in_object & 1);
+                in_object = (uint64_t)((int64_t)kind >> 63);
+
+                // The class of the token before each token, in two bits: `opened`
+                // alone after '{' or '[', both after ',', `valued` alone after a
+                // value, neither after ':' (or a string's opening quote)
+                uint64_t gaps = ~tokens;
+                auto follows = [&](uint64_t x, uint64_t& carry) {
+                    uint64_t sum;
+                    bool out = __builtin_add_overflow(gaps, (x << 1) | carry, &sum);
+                    carry = out | (x >> 63);
+                    return sum & tokens;
+                };
+                uint64_t value_end = close | scalar | close_quote;
+                uint64_t opened = follows(open | comma, c[0]);
+                uint64_t valued = follows(comma | value_end, c[1]);
+                uint64_t after_value = valued & ~opened, after_colon = ~(opened | valued);
+                uint64_t key_close = follows(open_quote & opened & object, c[2]);
+                uint64_t colon_due = follows(key_close, c[3]);
+                errors |= (open_quote & after_value)
+                        | ((open | scalar) & ~((opened & ~object) | after_colon))
+                        | (close & ((m.curly ^ object) | ~(opened ^ valued)))
+                        | (comma & ~after_value) | (colon ^ colon_due);
+
+                // Literals: spelled out from their first byte, no scalar byte after
+                uint64_t starts = scalar & (m.digit | m.minus);
+                uint64_t literals = scalar & ~starts;
+                uint64_t word4 = literals & m.word4, word5 = literals & m.word5;
+                errors |= (literals & ~(m.word4 | m.word5)) | (((word4 << 4) | (word5 << 5) | literal_carry) & m.scalar);
+                literal_carry = (word4 >> 60) | (word5 >> 59);
+
+                // Numbers: `run` spans each number's characters, checked against
+                // the byte before; one more add each finds a second '.' or exponent
+                uint64_t number_chars = m.digit | m.minus | m.plus | m.dot | m.exp;
+                uint64_t run = number_chars & ~Grammar::add(number_chars, starts, run_carry);
+                uint64_t digits = run & m.digit, exps = run & m.exp, dots = run & m.dot;
+                uint64_t after_digit = (digits << 1) | (prev_digits >> 63);
+                uint64_t after_exp = (exps << 1) | (prev_exps >> 63);
+                uint64_t minus_starts = starts & m.minus;
+                uint64_t lead_zeros = run & m.zero & (starts | (minus_starts << 1) | (prev_minus_starts >> 63));
+                uint64_t after_run = ((run << 1) | (prev_run >> 63)) & ~run;
+                uint64_t past_exp = Grammar::add(run, exps, exp_carry);
+                uint64_t numbers = (run & m.minus & ~starts & ~after_exp) | (run & m.plus & ~after_exp)
+                                 | ((dots | exps) & ~after_digit)
+                                 | (digits & ((lead_zeros << 1) | (prev_lead_zeros >> 63)))
+                                 | (dots & Grammar::add(run, dots, dot_carry)) | (exps & past_exp) | (dots & ~past_exp)
+                                 | (after_run & (~after_digit | m.scalar));
+                prev_run = run;
+                prev_digits = digits;
+                prev_exps = exps;
+                prev_minus_starts = minus_starts;
+                prev_lead_zeros = lead_zeros;
+
+                if (TACHYON_UNLIKELY((errors | faults | numbers) != 0)) {
+                    if (errors) bad = 64 * w + std::countr_zero(errors);
+                    if (faults) bad = std::min(bad, 64 * w + std::countr_zero(faults) - 1);  // At the backslash
+                    if (numbers) {
+                        int at = std::countr_zero(numbers);
+                        bad = std::min(bad, number_error(base, 64 * w + at, (after_digit >> at) & 1));
+                    }
+                    break;
+                }
+            }
+            stack = st;
+            level = lv;
+            for (int k = 0; k < 4; ++k) follow_carry[k] = c[k];
+            if (bad != npos) { error = bad; return false; }
+            return true;
+        }
+
+        // Before the root value is known to be a container: the first token must
+        // start a value, and a scalar or string root admits no token after it
+        uint64_t settle_root(uint64_t tokens, uint64_t open, uint64_t close, uint64_t scalar, uint64_t open_quote) {
+            auto after = [](uint64_t bit) { return ~(bit | (bit - 1)); };
+            if (root == RootDone || tokens == 0) return root == RootDone ? tokens : 0;
+            uint64_t head = tokens & (0 - tokens);
+            if (root == RootValue) {
+                if (head & open) { root = RootContainer; return 0; }
+                if (head & close) return head;
+                if (head & scalar) { root = RootDone; return tokens & after(head); }
+                if (!(head & open_quote)) return 0;  // Rejected as a token
+                root = RootString;
+                tokens &= after(head);
+                if (tokens == 0) return 0;
+                head = tokens & (0 - tokens);
+            }
+            // The string's closing quote
+            root = RootDone;
+            return tokens & after(head);
+        }
+
+        struct Rebalanced { uint64_t stack; int64_t level; uint64_t errors; };
+
+        // The bracket walk left the levels held in the register: spills or reloads
+        // 64 of them, and notices the root container closing
+        Rebalanced rebalance(uint64_t st, int64_t lv, int at, uint64_t tokens) {
+            if (lv == 64) {
+                spilled.push_back(st);
+                return { st, 0, 0 };
+            }
+            if (lv < 0) {
+                if (spilled.empty()) return { st, 0, 0 };  // A close at the top level, after the root ended
+                uint64_t outer = spilled.back();
+                spilled.pop_back();
+                return { outer >> 1, 63, 0 };
+            }
+            if (!spilled.empty()) return { spilled.back(), 0, 0 };  // The kinds below the register's
+            if (root != RootContainer) return { st, 0, 0 };
+            root = RootDone;
+            return { st, lv, tokens & (~1ULL << at) };
+        }
+
+        // Where a number fails whose first violation is at `at`: there when the
+        // bytes before it already form a number, else at the number's first byte
+        static size_t number_error(const char* base, size_t at, bool after_digit) {
+            if (after_digit) return at;
+            auto number_char = [](unsigned char ch) { return (unsigned)(ch - '0') < 10 || ch == '-' || ch == '+' || ch == '.' || (ch | 0x20) == 'e'; };
+            while (at > 0 && number_char((unsigned char)base[at - 1])) --at;
+            return at;
+        }
+    };
+
+    // -------------------------------------------------------------------------
+    // ERROR LOCATIONS
+    // -------------------------------------------------------------------------
+    // Where a parse failed. A failure records only the byte offset; line() and
+    // column() (1-based, the column in bytes) scan the prefix for newlines on
+    // first use and cache the result, so successful parses pay nothing and a
+    // failed multi-GB parse pays one bandwidth-bound pass, and only if asked.
+    // Reads the input it points into, which must outlive it.
+    class ParseError {
+    public:
+        static constexpr size_t npos = (size_t)-1;
+
+        ParseError() = default;
+        ParseError(const char* data, size_t len, size_t offset) : data(data), len(len), at(offset) {}
+
+        explicit operator bool() const { return at != npos; }
+        size_t offset() const { return at; }
+        size_t line() const { locate(); return cached_line; }
+        size_t column() const { locate(); return cached_column; }
+
+        // Located now and no longer reading the input, so it can outlive it
+        ParseError detached() const {
+            locate();
+            ParseError e = *this;
+            e.data = nullptr;
+            return e;
+        }
+
+        std::string message() const {
+            if (at == npos) return "Tachyon: no error";
+            return "Tachyon: invalid JSON at line " + std::to_string(line()) + ", column " + std::to_string(column()) +
+                   " (byte " + std::to_string(at) + ")";
+        }
+
+    private:
+        const char* data = nullptr;
+        size_t len = 0;
+        size_t at = npos;
+        mutable size_t cached_line = 0;  // 0 until located
+        mutable size_t cached_column = 0;
+
+        void locate() const {
+            if (cached_line || at == npos) return;
+            ASM::LineScan r = ASM::scan_lines(data, std::min(at, len));
+            cached_line = r.newlines + 1;
+            cached_column = at - r.line_start + 1;
+        }
+    };
+
+    // Thrown by the static json::parse / json::parse_view when a validating
+    // mode rejects the input (a Context returns null and reports error()).
+    // The location is resolved before the input can go away.
+    class ParseException : public std::runtime_error {
+    public:
+        explicit ParseException(const ParseError& e) : std::runtime_error(e.message()), where(e.detached()) {}
+        const ParseError& error() const { return where; }
+
+    private:
+        ParseError where;
+    };
+
+    // -------------------------------------------------------------------------
+    // WORKER POOL (Parallel Indexing)
+    // -------------------------------------------------------------------------
+    // Threads started on a document's first parallel parse and reused by every
+    // later one, so a parse costs a wake-up per worker rather than creating and
+    // joining threads. run(count, fn) calls fn(0) .. fn(count - 1) spread over
+    // the workers and the calling thread, and returns once all have finished.
+    // One run at a time: a document is parsed by one thread.
+    class WorkerPool {
+    public:
+        explicit WorkerPool(unsigned workers) {
+            threads.reserve(workers);
+            for (unsigned k = 0; k < workers; ++k) threads.emplace_back([this] { work(); });
+        }
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+        ~WorkerPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (auto& t : threads) t.join();
+        }
+
+        unsigned size() const { return (unsigned)threads.size(); }
+
+        template<typename F>
+        void run(size_t count, F& fn) {
+            {
+                // Workers still leaving the previous run read its counters
+                std::unique_lock<std::mutex> lock(mutex);
+                done.wait(lock, [&] { return active == 0; });
+                task = [](void* f, size_t k) { (*static_cast<F*>(f))(k); };
+                task_arg = &fn;
+                total = count;
+                next.store(0, std::memory_order_relaxed);
+                pending.store(count, std::memory_order_relaxed);
+                epoch++;
+            }
+            wake.notify_all();
+            drain();
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [&] { return pending.load(std::memory_order_acquire) == 0; });
+        }
+
+    private:
+        std::vector<std::thread> threads;
+        std::mutex mutex;
+        std::condition_variable wake;   // Workers: a new run or shutdown
+        std::condition_variable done;   // Caller: pending or active reached zero
+        void (*task)(void*, size_t) = nullptr;
+        void* task_arg = nullptr;
+        size_t total = 0;
+        std::atomic<size_t> next{0};     // Next index to claim
+        std::atomic<size_t> pending{0};  // Indices not yet finished
+        size_t active = 0;               // Workers inside drain()
+        uint64_t epoch = 0;
+        bool stopping = false;
+
+        void drain() {
+            for (size_t k; (k = next.fetch_add(1, std::memory_order_relaxed)) < total;) {
+                task(task_arg, k);
+                if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    done.notify_all();
+                }
+            }
+        }
+
+        void work() {
+            uint64_t seen = 0;
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                wake.wait(lock, [&] { return stopping || epoch != seen; });
+                if (stopping) return;
+                seen = epoch;
+                active++;
+                lock.unlock();
+                drain();
+                lock.lock();
+                if (--active == 0) done.notify_all();
+            }
+        }
+    };
+
+    class Document : public std::enable_shared_from_this<Document> {
+    public:
+        // Parallel indexing splits the buffer into chunks of at least this size
+        static constexpr size_t PARALLEL_MIN_CHUNK = 1 << 20;
+        // On-demand indexing advances the frontier this many bytes at a time (L2-sized)
+        static constexpr size_t ON_DEMAND_WINDOW = 64 << 10;
+        // Validating indexing checks this many bytes at a time (L1-sized)
+        static constexpr size_t VALIDATE_WINDOW = 16 << 10;
+        static constexpr size_t npos = (size_t)-1;
+
+        std::string storage;
+        std::unique_ptr<uint64_t[], AlignedDeleter> bitmask;     // One bit per byte, 64 bytes per word
+        std::unique_ptr<uint64_t[], AlignedDeleter> alt_bitmask;
+        std::unique_ptr<uint32_t[], AlignedDeleter> tape;       // Structural offsets, (uint32_t)-1 terminated
+        std::unique_ptr<uint64_t[], AlignedDeleter> wide_tape;  // Same, for documents of 4 GiB and up
+        std::unique_ptr<uint32_t[], AlignedDeleter> jumps;      // Tape index of each bracket's match (build_jumps)
+        std::unique_ptr<uint64_t[], AlignedDeleter> wide_jumps;
+        std::unique_ptr<uint64_t[], AlignedDeleter> float_bitmask;  // Raw '.', 'e', 'E' positions (build_types)
+        size_t len = 0;
+        size_t bitmask_len = 0;
+        size_t bitmask_cap = 0;
+        size_t alt_bitmask_cap = 0;
+        size_t float_bitmask_cap = 0;
+        size_t tape_len = 0;
+        size_t tape_cap = 0;
+        size_t wide_tape_cap = 0;
+        size_t jumps_cap = 0;
+        size_t wide_jumps_cap = 0;
+        size_t indexed_len = 0;          // Streaming / on-demand: bytes already indexed
+        SIMD::IndexState stream_state;   // Streaming / on-demand: carry at the indexed frontier
+        const char* source = nullptr;    // On-demand: the buffer being indexed
+        unsigned index_threads = 1; // 1 = single core, 0 = all hardware threads
+        std::unique_ptr<WorkerPool> workers;  // index_parallel: index_threads - 1 threads, kept across parses
+        bool index_on_demand = false; // Index in windows as cursors advance (ignored with build_tape / build_tree)
+        bool build_tape = false;    // Flatten the bitmask into `tape` after indexing
+        bool has_tape = false;
+        bool build_jumps = false;   // Also pair every bracket with its match (implies build_tape)
+        bool has_jumps = false;
+        bool build_tree = false;    // Build the succinct TreeIndex after indexing
+        bool has_tree = false;
+        TreeIndex tree;
+        bool build_types = false;   // Also record float markers so number typing is a lookup
+        bool has_types = false;
+        bool jsonc = false;         // Drop JSONC comments while indexing (indexes on one thread; Standard / Titan)
+        bool validate = false;      // Mode::Standard: check grammar, escapes and UTF-8 while indexing, as Titan always does
+        size_t error_offset = npos; // Mode::Titan: byte offset of the first error, npos if valid
+        SIMD::MaskFunction index_fn = nullptr;  // Indexing kernel, resolved per parse / stream
+        bool cursor_comments = true;  // Cursors step over comments left in the index, resolved per parse / stream
+        Arena arena;                  // Materialized nodes (arena_nodes), rewound by every parse
+        bool arena_nodes = false;     // Set by BasicContext, which keeps the document alive
+        bool borrow_nodes = false;    // Lazy nodes hold a plain pointer: no reference counting, the Context must outlive them
+        uint32_t generation = 0;      // Parses so far; lazy nodes record its low byte
+        std::atomic<size_t> borrowed_refs{0};  // Live borrowed nodes, counted when TACHYON_CHECK_BORROWS
+        alignas(64) std::atomic<size_t> node_refs{0};  // Owning lazy json nodes (retain / release)
+        std::mutex self_mutex;              // Serializes the 0 <-> 1 transitions of node_refs
+        std::shared_ptr<Document> self;     // Set while node_refs > 0
+        std::mutex unescape_mutex;          // Guards the unescape cache, written through const nodes
+        size_t* unescape_keys = nullptr;    // Unescape cache: string offset + 1 (0 = empty slot), in the arena
+        std::string_view* unescape_views = nullptr;
+        size_t unescape_cap = 0;
+        size_t unescape_count = 0;
+
+        // Lazy json nodes count their references here rather than each holding a
+        // shared_ptr. While any is alive the document owns itself through `self`.
+        // Steps between nonzero counts are a single CAS; the first reference and
+        // the last take self_mutex, so a count dropping to zero on one thread and
+        // raised from zero on another (a copy of an arena member node) never
+        // write `self` at once. Like the control block of a shared_ptr, the
+        // counter is one cache line shared by every owning node of the document,
+        // kept apart from the fields cursors read; readers on several threads
+        // avoid it entirely with borrow_nodes.
+        void retain() {
+            size_t n = node_refs.load(std::memory_order_relaxed);
+            while (n != 0) {
+                if (node_refs.compare_exchange_weak(n, n + 1, std::memory_order_relaxed)) return;
+            }
+            std::lock_guard<std::mutex> lock(self_mutex);
+            if (node_refs.fetch_add(1, std::memory_order_relaxed) == 0) self = shared_from_this();
+        }
+        void release() {
+            size_t n = node_refs.load(std::memory_order_relaxed);
+            while (n > 1) {
+                if (node_refs.compare_exchange_weak(n, n - 1, std::memory_order_acq_rel, std::memory_order_relaxed)) return;
+            }
+            std::shared_ptr<Document> last;  // Destroyed after the lock is released
+            std::lock_guard<std::mutex> lock(self_mutex);
+            if (node_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) last = std::move(self);
+        }
+
+        // The escaped string at `offset` unescaped into the arena, once per parse:
+        // later calls for the same offset return the same view. `unescape(p, raw)`
+        // writes the unescaped bytes (never more than raw.size()) and returns
+        // their count.
+        template<typename F>
+        std::string_view unescaped(size_t offset, std::string_view raw, F&& unescape) {
+            std::lock_guard<std::mutex> lock(unescape_mutex);
+            if (unescape_count * 2 >= unescape_cap) {
+                size_t* old_keys = unescape_keys;
+                std::string_view* old_views = unescape_views;
+                size_t old_cap = unescape_cap;
+                unescape_cap = std::max<size_t>(64, old_cap * 2);
+                unescape_keys = static_cast<size_t*>(arena.allocate(unescape_cap * sizeof(size_t), alignof(size_t)));
+                unescape_views = static_cast<std::string_view*>(arena.allocate(unescape_cap * sizeof(std::string_view), alignof(std::string_view)));
+                std::memset(unescape_keys, 0, unescape_cap * sizeof(size_t));
+                for (size_t i = 0; i < old_cap; ++i) {
+                    if (old_keys[i]) *unescape_slot(old_keys[i]) = old_views[i];
+                }
+            }
+            std::string_view* slot = unescape_slot(offset + 1);
+            if (slot->data()) return *slot;
+            char* p = static_cast<char*>(arena.allocate(raw.size(), 1));
+            *slot = std::string_view(p, unescape(p, raw));
+            unescape_count++;
+            return *slot;
+        }
+
+        // Finds or claims the slot of `key`; a claimed slot holds a null view
+        std::string_view* unescape_slot(size_t key) {
+            size_t mask = unescape_cap - 1;
+            for (size_t h = (key * 0x9E3779B97F4A7C15ULL) >> 32 & mask;; h = (h + 1) & mask) {
+                if (unescape_keys[h] == key) return unescape_views + h;
+                if (unescape_keys[h] == 0) {
+                    unescape_keys[h] = key;
+                    unescape_views[h] = std::string_view();
+                    return unescape_views + h;
+                }
+            }
+        }
+
+        // Rewinds the arena and everything allocated from it
+        void reset_arena() {
+            arena.reset();
+            unescape_keys = nullptr;
+            unescape_views = nullptr;
+            unescape_cap = unescape_count = 0;
+        }
+
+        // The untemplated entry points run Mode::Standard: every runtime flag applies
+        void parse(std::string&& json_str) { parse<Mode::Standard>(std::move(json_str)); }
+        void parse_view(const char* data, size_t size) { parse_view<Mode::Standard>(data, size); }
+
+        template<Mode M>
+        void parse(std::string&& json_str) {
+            storage = std::move(json_str);
+            parse_view<M>(storage.data(), storage.size());
+        }
+
+        template<Mode M>
+        void parse_view(const char* data, size_t size) {
+            len = size;
+            generation++;
+            reset_arena();
+            const bool comments = strips_comments<M>();
+            index_fn = SIMD::select_structural_mask(get_isa(Kernel::Index), comments);
+            cursor_comments = ModeTraits<M>::skip_comments && !comments && !validates<M>();
+            has_types = build_types;
+            reserve_bitmask((len + 63) / 64 + 1, 0);
+            source = data;
+            has_tape = false;
+            has_jumps = false;
+            has_tree = false;
+            error_offset = npos;
+            if (validates<M>()) {
+                bitmask_len = index_validated(data);
+                indexed_len = len;
+                if (error_offset == npos) build_side_indexes();
+                return;
+            }
+            if (index_on_demand && !wants_tape() && !build_tree) {
+                // Nothing is indexed up front; cursors call index_more() at the frontier
+                bitmask_len = 0;
+                indexed_len = 0;
+                stream_state = SIMD::IndexState{};
+                return;
+            }
+            unsigned threads = index_threads ? index_threads : std::max(1u, std::thread::hardware_concurrency());
+            if (threads > 1 && !comments && len >= 2 * PARALLEL_MIN_CHUNK) {
+                bitmask_len = index_parallel(data, threads);
+            } else {
+                SIMD::IndexState state;
+                bitmask_len = index_fn(data, len, bitmask.get(), state, nullptr, float_out(0));
+            }
+            indexed_len = len;
+            build_side_indexes();
+        }
+
+        // Location of the first error (empty unless a validating parse failed)
+        ParseError error() const { return error_offset == npos ? ParseError() : ParseError(source, len, error_offset); }
 
-                uint64_t p = quote_mask;
-                p ^= (p << 1); p ^= (p << 2); p ^= (p << 4); p ^= (p << 8); p ^= (p << 16); p ^= (p << 32);
-                p ^= in_string_mask;
+        // Mode policy against the runtime flags: constant false where M rules them out
+        template<Mode M> bool strips_comments() const { return ModeTraits<M>::jsonc && jsonc; }
+        template<Mode M> bool validates() const { return ModeTraits<M>::validate || (ModeTraits<M>::optional_validate && validate); }
 
-                uint64_t odd = std::popcount(quote_mask) & 1;
-                in_string_mask ^= (0 - odd);
+        // ---------------------------------------------------------------------
+        // ON-DEMAND INDEXING
+        // ---------------------------------------------------------------------
+        // With index_on_demand, parse_view only sizes the bitmask. Cursors that run
+        // past bitmask_len index the next window, so a lookup near the head of a
+        // large document touches only the windows it reads. The bitmask is
+        // allocated in full up front, so cursors never see it move. Readers extend
+        // the index through const accessors: a document being indexed on demand
+        // must not be navigated from several threads at once.
+        bool fully_indexed() const { return indexed_len >= len; }
+
+        // Indexes the next window; returns false once the whole document is indexed
+        bool index_more() {
+            if (fully_indexed()) return false;
+            size_t n = std::min(ON_DEMAND_WINDOW, len - indexed_len);
+            size_t blocks = index_fn(source + indexed_len, n, bitmask.get() + indexed_len / 64, stream_state, nullptr, float_out(indexed_len / 64));
+            bitmask_len = indexed_len / 64 + blocks;
+            indexed_len += n;
+            SIMD::settle_comment_edge(stream_state, bitmask.get() + bitmask_len - 1, source + indexed_len, source + len);
+            return true;
+        }
 
-                uint64_t final_mask = (struct_mask & ~p) | quote_mask;
+        // ---------------------------------------------------------------------
+        // VALIDATING INDEX (Mode::Titan)
+        // ---------------------------------------------------------------------
+        // One pass in L1-sized windows: each window is indexed, then checked for
+        // UTF-8, control characters and escapes, and its tokens are fed through
+        // the grammar automaton while the bytes are still in cache. UTF-8 runs up
+        // to the last sequence boundary of the window, so no sequence is split.
+        // Stops at the first error and records its offset in error_offset.
+        size_t index_validated(const char* data) {
+            SIMD::IndexState state;
+            Validator grammar;
+            const bool fused = !jsonc && g_dispatch.vbmi2 && get_isa(Kernel::Index) == ISA::AVX512 && get_isa(Kernel::Utf8) == ISA::AVX512;
+            size_t blocks = 0, utf8_from = 0;
+            for (size_t at = 0; at < len; at += VALIDATE_WINDOW) {
+                size_t n = std::min(VALIDATE_WINDOW, len - at);
+                size_t count = (n + 63) / 64;
+                bool checked = fused && grammar.index_avx512(data, len, at, n, bitmask.get(), float_out(0), state);
+                if (!checked) count = index_fn(data + at, n, bitmask.get() + at / 64, state, nullptr, float_out(at / 64));
+                blocks = at / 64 + count;
+                SIMD::settle_comment_edge(state, bitmask.get() + blocks - 1, data + at + n, data + len);
+
+                size_t utf8_to = at + n;
+                while (utf8_to < len && utf8_to > at + n - 3 && ((unsigned char)data[utf8_to] & 0xC0) == 0x80) --utf8_to;
+                size_t first_error = npos;
+                if (!ASM::validate_utf8(data + utf8_from, utf8_to - utf8_from)) {
+                    first_error = utf8_from + ASM::utf8_error_offset(data + utf8_from, utf8_to - utf8_from);
+                }
+                utf8_from = utf8_to;
 
-                mask_array[block_idx++] = (uint32_t)final_mask;
-                mask_array[block_idx++] = (uint32_t)(final_mask >> 32);
+                if (!checked && !grammar.feed(data, len, bitmask.get(), at / 64, count)) {
+                    first_error = std::min(first_error, grammar.error);
+                }
+                if (first_error != npos) { error_offset = first_error; return blocks; }
             }
+            if (!grammar.finish(data, len, bitmask.get(), blocks)) error_offset = grammar.error;
+            return blocks;
+        }
 
-            // Masked Tail (0-63 bytes)
-            if (i < len) {
-                size_t remaining = len - i;
-                uint64_t load_mask = (1ULL << remaining) - 1;
-
-                __m512i chunk = _mm512_maskz_loadu_epi8(load_mask, reinterpret_cast<const void*>(data + i));
+        // ---------------------------------------------------------------------
+        // STREAMING (Incremental Indexing)
+        // ---------------------------------------------------------------------
+        // Bytes are copied into `storage` as they arrive and indexed in whole
+        // 128-byte units while still hot in cache; IndexState carries the escape
+        // and in-string state across appends. finish_stream() indexes the tail.
+        // All three calls of one stream take the same Mode.
+        void begin_stream(size_t size_hint = 0) { begin_stream<Mode::Standard>(size_hint); }
+        void append(const char* data, size_t size) { append<Mode::Standard>(data, size); }
+        void finish_stream() { finish_stream<Mode::Standard>(); }
+
+        template<Mode M>
+        void begin_stream(size_t size_hint = 0) {
+            generation++;
+            reset_arena();
+            storage.clear();
+            storage.reserve(size_hint);
+            len = 0;
+            bitmask_len = 0;
+            indexed_len = 0;
+            stream_state = SIMD::IndexState{};
+            has_tape = false;
+            has_jumps = false;
+            has_tree = false;
+            error_offset = npos;
+            index_fn = SIMD::select_structural_mask(get_isa(Kernel::Index), strips_comments<M>());
+            cursor_comments = ModeTraits<M>::skip_comments && !strips_comments<M>() && !validates<M>();
+            has_types = build_types;
+            reserve_bitmask(size_hint / 64 + 1, 0);
+        }
 
-                uint64_t bs_mask = _mm512_cmpeq_epi8_mask(chunk, v_slash);
-                uint64_t quote_mask = _mm512_cmpeq_epi8_mask(chunk, v_quote);
+        // When validating, chunks are only buffered: finish_stream() runs the validating pass
+        template<Mode M>
+        void append(const char* data, size_t size) {
+            storage.append(data, size);
+            if (validates<M>()) return;
+            size_t ready = (storage.size() - indexed_len) & ~(size_t)127;
+            if (ready == 0) return;
+            reserve_bitmask((indexed_len + ready) / 64 + 1, indexed_len / 64);
+            index_fn(storage.data() + indexed_len, ready, bitmask.get() + indexed_len / 64, stream_state, nullptr, float_out(indexed_len / 64));
+            indexed_len += ready;
+        }
 
-                uint64_t struct_mask =
-                    _mm512_cmpeq_epi8_mask(chunk, v_lbra) | _mm512_cmpeq_epi8_mask(chunk, v_rbra) |
-                    _mm512_cmpeq_epi8_mask(chunk, v_lcur) | _mm512_cmpeq_epi8_mask(chunk, v_rcur) |
-                    _mm512_cmpeq_epi8_mask(chunk, v_col) | _mm512_cmpeq_epi8_mask(chunk, v_com);
+        template<Mode M>
+        void finish_stream() {
+            len = storage.size();
+            reserve_bitmask((len + 63) / 64 + 1, indexed_len / 64);
+            source = storage.data();
+            if (validates<M>()) {
+                bitmask_len = index_validated(source);
+                indexed_len = len;
+                if (error_offset == npos) build_side_indexes();
+                return;
+            }
+            size_t tail_blocks = 0;
+            if (indexed_len < len) {
+                tail_blocks = index_fn(storage.data() + indexed_len, len - indexed_len, bitmask.get() + indexed_len / 64, stream_state, nullptr, float_out(indexed_len / 64));
+            }
+            bitmask_len = indexed_len / 64 + tail_blocks;
+            indexed_len = len;
+            build_side_indexes();
+        }
 
-                bs_mask &= load_mask;
-                quote_mask &= load_mask;
-                struct_mask &= load_mask;
+        // Grows the bitmask (and float mask) to `req_len` words, preserving the first `keep` words
+        void reserve_bitmask(size_t req_len, size_t keep) {
+            grow_words(bitmask, bitmask_cap, req_len, keep);
+            if (has_types) grow_words(float_bitmask, float_bitmask_cap, req_len, keep);
+        }
 
-                if (TACHYON_UNLIKELY(bs_mask != 0 || prev_escapes > 0)) {
-                    uint64_t real_quote_mask = 0;
-                    const char* c_ptr = data + i;
-                     for(size_t j=0; j<remaining; ++j) {
-                         if (c_ptr[j] == '"' && (prev_escapes & 1) == 0) real_quote_mask |= (1ULL << j);
-                         if (c_ptr[j] == '\\') prev_escapes++; else prev_escapes = 0;
-                     }
-                     quote_mask = real_quote_mask;
-                }
+        static void grow_words(std::unique_ptr<uint64_t[], AlignedDeleter>& words, size_t& cap, size_t req_len, size_t keep) {
+            if (req_len <= cap) return;
+            if (keep) req_len = std::max(req_len, cap * 2);
+            std::unique_ptr<uint64_t[], AlignedDeleter> grown(static_cast<uint64_t*>(ASM::aligned_alloc(req_len * sizeof(uint64_t))));
+            if (keep) std::memcpy(grown.get(), words.get(), keep * sizeof(uint64_t));
+            words = std::move(grown);
+            cap = req_len;
+        }
 
-                uint64_t p = quote_mask;
-                p ^= (p << 1); p ^= (p << 2); p ^= (p << 4); p ^= (p << 8); p ^= (p << 16); p ^= (p << 32);
-                p ^= in_string_mask;
+        uint64_t* float_out(size_t block) { return has_types ? float_bitmask.get() + block : nullptr; }
+
+        // True if a '.', 'e' or 'E' lies in [begin, end). Requires has_types.
+        bool span_has_float(size_t begin, size_t end) const {
+            if (begin >= end) return false;
+            size_t first = begin / 64, last = (end - 1) / 64;
+            for (size_t b = first; b <= last; ++b) {
+                uint64_t w = float_bitmask[b];
+                if (b == first) w &= ~0ULL << (begin % 64);
+                if (b == last && end % 64) w &= (1ULL << (end % 64)) - 1;
+                if (w) return true;
+            }
+            return false;
+        }
 
-                uint64_t final_mask = (struct_mask & ~p) | quote_mask;
-                final_mask &= load_mask;
+        // Offsets of 4 GiB and up (and the 32-bit sentinel itself) need 64-bit cursors
+        bool wide_offsets() const { return len >= (size_t)UINT32_MAX; }
 
-                mask_array[block_idx++] = (uint32_t)final_mask;
-                mask_array[block_idx++] = (uint32_t)(final_mask >> 32);
-            }
+        template<typename Offset>
+        const Offset* tape_data() const {
+            if constexpr (std::is_same_v<Offset, uint64_t>) return wide_tape.get();
+            else return tape.get();
+        }
 
-             _mm256_zeroupper();
-            return block_idx;
+        template<typename Offset>
+        const Offset* jump_data() const {
+            if (!has_jumps) return nullptr;
+            if constexpr (std::is_same_v<Offset, uint64_t>) return wide_jumps.get();
+            else return jumps.get();
         }
 
-        // Pointer to the active implementation
-        static size_t (*compute_structural_mask)(const char*, size_t, uint32_t*) = nullptr;
-    }
+        bool wants_tape() const { return build_tape || build_jumps; }
 
-    struct AlignedDeleter { void operator()(uint32_t* p) const { ASM::aligned_free(p); } };
+        // Optional stages over the finished bitmask
+        void build_side_indexes() {
+            if (wants_tape()) flatten();
+            if (build_tree) {
+                tree.build(bitmask.get(), bitmask_len, source, len);
+                has_tree = true;
+            }
+        }
 
-    class Document {
-    public:
-        std::string storage;
-        std::unique_ptr<uint32_t[], AlignedDeleter> bitmask;
-        size_t len = 0;
-        size_t bitmask_len = 0;
-        size_t bitmask_cap = 0;
+        // Optional stage 1.5: dense array of structural offsets for per-token cursors
+        void flatten() {
+            size_t count = 0;
+            for (size_t b = 0; b < bitmask_len; ++b) count += std::popcount(bitmask[b]);
+            if (wide_offsets()) flatten_into(wide_tape, wide_tape_cap, count);
+            else flatten_into(tape, tape_cap, count);
+            has_tape = true;
+            if (build_jumps) {
+                if (wide_offsets()) pair_brackets(wide_jumps, wide_jumps_cap);
+                else pair_brackets(jumps, jumps_cap);
+                has_jumps = true;
+            }
+        }
 
-        Document() {
-            if (!SIMD::compute_structural_mask) {
-                 if (g_active_isa == ISA::AVX512) SIMD::compute_structural_mask = SIMD::compute_structural_mask_avx512;
-                 else SIMD::compute_structural_mask = SIMD::compute_structural_mask_avx2;
+        template<typename Offset>
+        void flatten_into(std::unique_ptr<Offset[], AlignedDeleter>& out, size_t& cap, size_t count) {
+            size_t req_len = count + 64;
+            if (req_len > cap) {
+                out.reset(static_cast<Offset*>(ASM::aligned_alloc(req_len * sizeof(Offset))));
+                cap = req_len;
             }
+            tape_len = SIMD::flatten_bitmask(bitmask.get(), bitmask_len, out.get());
+            out[tape_len] = (Offset)-1;
         }
 
-        void parse(std::string&& json_str) {
-            storage = std::move(json_str);
-            parse_view(storage.data(), storage.size());
+        // Jump table: for the tape index of every '{' / '[', the tape index of its
+        // matching close, so a cursor skips a whole subtree in one step. Built with
+        // a stack over the same JSONC-aware walk readers use; an unclosed bracket
+        // jumps to the end of the tape. Any other token (e.g. a bracket inside a
+        // comment) maps to itself, so a jump from it is a plain step.
+        template<typename Offset>
+        void pair_brackets(std::unique_ptr<Offset[], AlignedDeleter>& out, size_t& cap) {
+            size_t req_len = tape_len + 1;
+            if (req_len > cap) {
+                out.reset(static_cast<Offset*>(ASM::aligned_alloc(req_len * sizeof(Offset))));
+                cap = req_len;
+            }
+            for (size_t i = 0; i < tape_len; ++i) out[i] = (Offset)i;
+            const Offset* t = tape_data<Offset>();
+            std::vector<Offset> open;
+            auto walk = [&](auto c) {
+                for (Offset curr = c.next(); curr != c.npos; curr = c.next()) {
+                    char ch = source[curr];
+                    Offset idx = (Offset)(c.tape_pos - 1 - t);
+                    if (ch == '{' || ch == '[') open.push_back(idx);
+                    else if ((ch == '}' || ch == ']') && !open.empty()) { out[open.back()] = idx; open.pop_back(); }
+                }
+            };
+            if (cursor_comments) walk(BasicCursor<true, Offset, true>(this, 0, source));
+            else walk(BasicCursor<true, Offset, false>(this, 0, source));
+            for (Offset idx : open) out[idx] = (Offset)(tape_len - 1);
         }
 
-        void parse_view(const char* data, size_t size) {
-            len = size;
-            size_t req_len = (len + 31) / 32 + 2;
-            if (req_len > bitmask_cap) {
-                bitmask.reset(static_cast<uint32_t*>(ASM::aligned_alloc(req_len * sizeof(uint32_t))));
-                bitmask_cap = req_len;
+        // Speculative parallel stage 1. Every chunk is indexed as if it starts outside
+        // a string, emitting the inside-a-string variant into alt_bitmask alongside.
+        // A serial pass over the per-chunk quote parities then finds the true entry
+        // state, and chunks that started inside a string swap in their alternate mask.
+        // The escape and scalar-run state at a boundary need no speculation: they are
+        // the parity of the backslash run and the class of the byte just before it.
+        // Both passes run on `workers`, started by the first parallel parse.
+        size_t index_parallel(const char* data, unsigned threads) {
+            size_t req_len = (len + 63) / 64 + 1;
+            if (req_len > alt_bitmask_cap) {
+                alt_bitmask.reset(static_cast<uint64_t*>(ASM::aligned_alloc(req_len * sizeof(uint64_t))));
+                alt_bitmask_cap = req_len;
             }
-            bitmask_len = SIMD::compute_structural_mask(data, len, bitmask.get());
+
+            // Chunk boundaries on 128-byte multiples keep every kernel on whole, aligned blocks
+            size_t chunk = std::max(PARALLEL_MIN_CHUNK, ((len / threads) + 127) & ~(size_t)127);
+            size_t chunk_count = (len + chunk - 1) / chunk;
+            std::vector<SIMD::IndexState> exit_state(chunk_count);
+            std::vector<uint8_t> entered_in_string(chunk_count, 0);
+            size_t last_blocks = 0;
+            if (!workers || workers->size() != threads - 1) workers = std::make_unique<WorkerPool>(threads - 1);
+
+            auto index_chunk = [&](size_t k) {
+                size_t begin = k * chunk;
+                size_t size = std::min(chunk, len - begin);
+                size_t run = 0;
+                while (run < begin && data[begin - 1 - run] == '\\') run++;
+
+                SIMD::IndexState state;
+                state.prev_escaped = run & 1;
+                state.prev_scalar = begin && (SIMD::byte_class_table.v[(unsigned char)data[begin - 1]] & SIMD::CLASS_NON_SCALAR) == 0;
+                size_t blocks = index_fn(data + begin, size, bitmask.get() + begin / 64, state, alt_bitmask.get() + begin / 64, float_out(begin / 64));
+                exit_state[k] = state;
+                if (k == chunk_count - 1) last_blocks = blocks;
+            };
+            workers->run(chunk_count, index_chunk);
+
+            uint64_t in_string = 0;
+            bool any_swap = false;
+            for (size_t k = 0; k < chunk_count; ++k) {
+                entered_in_string[k] = in_string != 0;
+                any_swap |= in_string != 0;
+                in_string ^= exit_state[k].in_string;
+            }
+
+            auto swap_chunk = [&](size_t k) {
+                if (!entered_in_string[k]) return;
+                size_t begin = k * chunk;
+                size_t blocks = k == chunk_count - 1 ? last_blocks : chunk / 64;
+                std::memcpy(bitmask.get() + begin / 64, alt_bitmask.get() + begin / 64, blocks * sizeof(uint64_t));
+            };
+            if (any_swap) workers->run(chunk_count, swap_chunk);
+
+            return (chunk_count - 1) * (chunk / 64) + last_blocks;
         }
         const char* get_base() const { return storage.empty() ? nullptr : storage.data(); }
     };
@@ -538,92 +3498,148 @@ namespace Tachyon {
     // -------------------------------------------------------------------------
     // CURSOR
     // -------------------------------------------------------------------------
-    struct Cursor {
-        const uint32_t* bitmask_ptr;
+    // UseTape = false walks the bitmask block by block; UseTape = true reads the
+    // flattened offset tape, one load per structural character. Offset is
+    // uint64_t only for documents of 4 GiB and up (Document::wide_offsets).
+    template<bool UseTape, typename Offset, bool Comments>
+    struct BasicCursor {
+        using offset_type = Offset;
+        static constexpr Offset npos = (Offset)-1;
+
+        const uint64_t* bitmask_ptr;
         size_t max_block;
-        uint32_t block_idx;
-        uint32_t mask;
+        Offset block_idx;
+        uint64_t mask;
+        const Offset* tape_begin;
+        const Offset* tape_end;
+        const Offset* tape_pos;
+        const Offset* jump_table;  // Document::jump_data, or null
         const char* base;
         const char* end_ptr;
+        Document* frontier_doc;  // Set while the document is still being indexed on demand
 
-        Cursor(const Document* d, uint32_t offset, const char* b_ptr) : base(b_ptr) {
+        BasicCursor(Document* d, size_t offset, const char* b_ptr) : base(b_ptr) {
             end_ptr = b_ptr + d->len;
             bitmask_ptr = d->bitmask.get();
             max_block = d->bitmask_len;
-            block_idx = offset / 32;
-            int bit = offset % 32;
-            if (block_idx < max_block) {
-                mask = bitmask_ptr[block_idx];
-                mask &= ~((1U << bit) - 1);
-            } else { mask = 0; }
+            frontier_doc = d->fully_indexed() ? nullptr : d;
+            tape_begin = d->template tape_data<Offset>();
+            tape_end = tape_begin + d->tape_len;
+            jump_table = UseTape ? d->template jump_data<Offset>() : nullptr;
+            seek((Offset)offset);
+        }
+
+        // Positions the cursor on the first structural character at or after `offset`
+        TACHYON_FORCE_INLINE void seek(Offset offset) {
+            if constexpr (UseTape) {
+                tape_pos = std::lower_bound(tape_begin, tape_end, offset);
+            } else {
+                block_idx = offset / 64;
+                int bit = offset % 64;
+                if (block_idx < max_block || extend()) {
+                    mask = bitmask_ptr[block_idx] & (~0ULL << bit);
+                } else { mask = 0; }
+            }
         }
 
         // Fast Path: No JSONC support (Turbo / Apex)
-        TACHYON_FORCE_INLINE uint32_t next_fast() {
-            while (true) {
-                if (mask != 0) {
-                    int bit = std::countr_zero(mask);
-                    uint32_t offset = block_idx * 32 + bit;
-                    mask &= (mask - 1);
-                    return offset;
+        TACHYON_FORCE_INLINE Offset next_fast() {
+            if constexpr (UseTape) {
+                // The tape is terminated by npos, so the end needs no bounds check
+                Offset offset = *tape_pos;
+                tape_pos += (offset != npos);
+                return offset;
+            } else {
+                while (true) {
+                    if (mask != 0) {
+                        int bit = std::countr_zero(mask);
+                        Offset offset = block_idx * 64 + bit;
+                        mask &= (mask - 1);
+                        return offset;
+                    }
+                    block_idx++;
+                    if (block_idx >= max_block && !extend()) return npos;
+                    mask = bitmask_ptr[block_idx];
                 }
-                block_idx++;
-                if (block_idx >= max_block) return (uint32_t)-1;
-                mask = bitmask_ptr[block_idx];
             }
         }
 
-        // Safe Path: Handles JSONC (Standard / Titan)
-        inline uint32_t next() {
-            while (true) {
-                if (mask != 0) {
-                    int bit = std::countr_zero(mask);
-                    uint32_t offset = block_idx * 32 + bit;
-                    mask &= (mask - 1);
+        // Right after next() / next_fast() returned the opening bracket at `open`,
+        // moves past its matching close: one step through the jump table when the
+        // document has one, else a bracket-depth scan of the bitmask 64 bytes at a
+        // time. Returns false, leaving the cursor as it was, when the scan gives up
+        // (a comment or the on-demand frontier in the way).
+        TACHYON_FORCE_INLINE bool jump_past_match(Offset open) {
+            if constexpr (UseTape) {
+                if (jump_table) {
+                    tape_pos = tape_begin + jump_table[tape_pos - 1 - tape_begin] + 1;
+                    return true;
+                }
+            }
+            SIMD::DepthScan r = SIMD::scan_depth<false>(base, (size_t)(end_ptr - base), bitmask_ptr, max_block, (size_t)open + 1, 1);
+            if (r.close == SIMD::DepthScan::npos) return false;
+            if constexpr (UseTape) {
+                // Gallop from the current entry: short skips stay short
+                Offset target = (Offset)r.close + 1;
+                size_t step = 1;
+                const Offset* lo = tape_pos;
+                while (lo + step < tape_end && lo[step] < target) { lo += step; step <<= 1; }
+                tape_pos = std::lower_bound(lo, std::min(lo + step, tape_end), target);
+            } else {
+                seek((Offset)r.close + 1);
+            }
+            return true;
+        }
+
+        // On-demand documents: indexes further until `block_idx` is covered
+        bool extend() {
+            if (TACHYON_LIKELY(!frontier_doc)) return false;
+            while (block_idx >= frontier_doc->bitmask_len) {
+                if (!frontier_doc->index_more()) break;
+            }
+            max_block = frontier_doc->bitmask_len;
+            if (frontier_doc->fully_indexed()) frontier_doc = nullptr;
+            return block_idx < max_block;
+        }
+
+        // Safe Path: steps over JSONC comments a plain index kept (Mode::Standard
+        // without `jsonc`). Other cursors compile it to next_fast().
+        inline Offset next() {
+            if constexpr (!Comments) {
+                return next_fast();
+            } else {
+                while (true) {
+                    Offset offset = next_fast();
+                    if (offset == npos) return offset;
 
                     if (TACHYON_UNLIKELY(base[offset] == '/')) {
-                         if (base + offset + 1 >= end_ptr) return (uint32_t)-1;
+                         if (base + offset + 1 >= end_ptr) return npos;
                          const char* p = base + offset + 2;
                          if (base[offset+1] == '/') {
                              while(p < end_ptr && *p != '\n') p++;
-                             uint32_t new_off = (uint32_t)(p - base);
-                             block_idx = new_off / 32;
-                             int b = new_off % 32;
-                             if (block_idx < max_block) {
-                                 mask = bitmask_ptr[block_idx];
-                                 mask &= ~((1U << b) - 1);
-                             } else { mask = 0; }
+                             seek((Offset)(p - base));
                              continue;
                          } else if (base[offset+1] == '*') {
                              while(p < end_ptr - 1 && !(*p == '*' && *(p+1) == '/')) p++;
-                             uint32_t new_off = (uint32_t)(p - base) + 2;
-                             block_idx = new_off / 32;
-                             int b = new_off % 32;
-                             if (block_idx < max_block) {
-                                 mask = bitmask_ptr[block_idx];
-                                 mask &= ~((1U << b) - 1);
-                             } else { mask = 0; }
+                             seek((Offset)(p - base) + 2);
                              continue;
                          }
                     }
                     return offset;
                 }
-                block_idx++;
-                if (block_idx >= max_block) return (uint32_t)-1;
-                mask = bitmask_ptr[block_idx];
             }
         }
 
         // Direct-Key-Jump (Apex Optimization)
-        TACHYON_FORCE_INLINE uint32_t find_key(const char* key, size_t len) {
+        TACHYON_FORCE_INLINE Offset find_key(const char* key, size_t len) {
              while (true) {
-                uint32_t curr = next_fast();
-                if (curr == (uint32_t)-1) return (uint32_t)-1;
+                Offset curr = next_fast();
+                if (curr == npos) return npos;
                 char c = base[curr];
-                if (c == '}') return (uint32_t)-1;
+                if (c == '}') return npos;
                 if (c == '"') {
-                    uint32_t next_struct = next_fast();
-                    if (next_struct == (uint32_t)-1) return (uint32_t)-1;
+                    Offset next_struct = next_fast();
+                    if (next_struct == npos) return npos;
                     size_t k_len = next_struct - curr - 1;
                     if (k_len == len) {
                         // OPTIMIZED COMPARISON
@@ -635,17 +3651,20 @@ namespace Tachyon {
                             if (memcmp(base + curr + 1, key, len) == 0) return next_struct;
                         }
                     }
-                    uint32_t colon = next_fast();
+                    Offset colon = next_fast();
                     if (base[colon] != ':') continue;
 
                     int depth = 0;
                     while(true) {
-                        uint32_t v_curr = next_fast();
-                        if (v_curr == (uint32_t)-1) return (uint32_t)-1;
+                        Offset v_curr = next_fast();
+                        if (v_curr == npos) return npos;
                         char vc = base[v_curr];
-                        if (vc == '{' || vc == '[') depth++;
+                        if (vc == '{' || vc == '[') {
+                            if (depth == 0 && jump_past_match(v_curr)) continue;
+                            depth++;
+                        }
                         else if (vc == '}' || vc == ']') {
-                            if (depth == 0) return (uint32_t)-1;
+                            if (depth == 0) return npos;
                             depth--;
                         }
                         else if (vc == ',') {
@@ -657,22 +3676,391 @@ namespace Tachyon {
         }
     };
 
-    using ObjectType = std::map<std::string, class json, std::less<>>;
-    using ArrayType = std::vector<class json>;
-    struct LazyNode { std::shared_ptr<Document> doc; uint32_t offset; const char* base_ptr; };
+    using Cursor = BasicCursor<false>;
+    using TapeCursor = BasicCursor<true>;
+    using WideCursor = BasicCursor<false, uint64_t>;
+    using WideTapeCursor = BasicCursor<true, uint64_t>;
+
+    // -------------------------------------------------------------------------
+    // OBJECT STORAGE
+    // -------------------------------------------------------------------------
+    // Members are kept in insertion order in blocks that never move, so a
+    // reference to a member survives later inserts (`j["b"] = j["a"]`).
+    // Materializing an object sizes the first block to its member count: one
+    // allocation (keys within the SSO size allocate nothing), and lookups walk
+    // contiguous memory. Each further block doubles the capacity. Up to
+    // HASH_MIN members a lookup compares keys linearly, length first. Past that
+    // size an open-addressing table of member indices is kept next to the
+    // blocks. A repeated key keeps its first position and takes the last value.
+    template<typename Object, typename T>
+    class MemberIterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::remove_const_t<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        MemberIterator() = default;
+        MemberIterator(Object* obj, size_t i) : obj(obj), i(i) {}
+
+        T& operator*() const { return obj->member(i); }
+        T* operator->() const { return &obj->member(i); }
+        MemberIterator& operator++() { ++i; return *this; }
+        MemberIterator operator++(int) { MemberIterator t = *this; ++i; return t; }
+        MemberIterator operator+(difference_type n) const { return MemberIterator(obj, i + n); }
+        difference_type operator-(const MemberIterator& o) const { return (difference_type)(i - o.i); }
+        bool operator==(const MemberIterator& o) const { return i == o.i; }
+
+    private:
+        Object* obj = nullptr;
+        size_t i = 0;
+    };
+
+    template<typename Value>
+    class FlatObject {
+    public:
+        using value_type = std::pair<String, Value>;
+        using iterator = MemberIterator<FlatObject, value_type>;
+        using const_iterator = MemberIterator<const FlatObject, const value_type>;
+        static constexpr size_t HASH_MIN = 16;
+
+        FlatObject() = default;
+        explicit FlatObject(ArenaAllocator<char> alloc) : slots(alloc) {}
+        // Copies are on the heap, like those of the other containers
+        FlatObject(const FlatObject& o) : slots(o.slots) {
+            reserve(o.count);
+            for (; count < o.count; ++count) new (first + count) value_type(o.member(count));
+        }
+        FlatObject& operator=(const FlatObject&) = delete;
+        ~FlatObject() {
+            for (size_t i = 0; i < count; ++i) member(i).~value_type();
+            if (!first) return;
+            ArenaAllocator<value_type> alloc(get_allocator());
+            alloc.deallocate(first, first_cap);
+            if (!more) return;
+            for (size_t k = 0; k < blocks; ++k) alloc.deallocate(more[k], (size_t)first_cap << k);
+            ArenaAllocator<value_type*>(alloc).deallocate(more, MAX_BLOCKS);
+        }
+
+        iterator begin() { return iterator(this, 0); }
+        iterator end() { return iterator(this, count); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, count); }
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        ArenaAllocator<char> get_allocator() const { return slots.get_allocator(); }
+
+        // Sizes the first block; later blocks double the capacity
+        void reserve(size_t n) {
+            if (first || n == 0) return;
+            first = ArenaAllocator<value_type>(get_allocator()).allocate(n);
+            first_cap = (uint32_t)n;
+        }
+
+        iterator find(std::string_view key) { size_t i = index_of(key); return i == npos ? end() : begin() + i; }
+        const_iterator find(std::string_view key) const { size_t i = index_of(key); return i == npos ? end() : begin() + i; }
+        bool contains(std::string_view key) const { return index_of(key) != npos; }
+
+        Value& operator[](std::string_view key) { return emplace(key); }
+
+        // Block k > 0 holds members [first_cap << (k - 1), first_cap << k)
+        value_type& member(size_t i) const {
+            if (TACHYON_LIKELY(i < first_cap)) return first[i];
+            size_t k = (size_t)std::bit_width(i / first_cap);
+            return more[k - 1][i - ((size_t)first_cap << (k - 1))];
+        }
+
+    private:
+        static constexpr size_t npos = (size_t)-1;
+        static constexpr size_t MAX_BLOCKS = 32;  // Capacity doubles per block; member indices are 32-bit
+        value_type* first = nullptr;
+        value_type** more = nullptr;  // Blocks after the first: MAX_BLOCKS entries once the object grows
+        uint32_t first_cap = 0;
+        uint32_t count = 0;
+        uint32_t blocks = 0;          // Entries of `more` in use
+        std::vector<uint32_t, ArenaAllocator<uint32_t>> slots;  // Member index + 1, 0 = empty; a power of two, at most half full
+
+        size_t index_of(std::string_view key) const {
+            if (slots.empty()) {
+                // Members past the first block: an object grown by writes
+                if (TACHYON_UNLIKELY(count > first_cap)) return scan_blocks(key);
+                for (size_t i = 0; i < count; ++i) {
+                    const String& k = first[i].first;
+                    if (k.size() == key.size() && std::memcmp(k.data(), key.data(), key.size()) == 0) return i;
+                }
+                return npos;
+            }
+            size_t mask = slots.size() - 1;
+            for (size_t h = std::hash<std::string_view>{}(key) & mask;; h = (h + 1) & mask) {
+                uint32_t slot = slots[h];
+                if (slot == 0) return npos;
+                if (std::string_view(member(slot - 1).first) == key) return slot - 1;
+            }
+        }
+
+        size_t scan_blocks(std::string_view key) const {
+            for (size_t i = 0; i < count; ++i) {
+                if (std::string_view(member(i).first) == key) return i;
+            }
+            return npos;
+        }
+
+        Value& emplace(std::string_view key) {
+            size_t i = index_of(key);
+            if (i != npos) return member(i).second;
+            value_type* m = first + count;
+            if (TACHYON_UNLIKELY(count >= first_cap)) {
+                if (!first) reserve(4);
+                else if (count == (size_t)first_cap << blocks) grow();
+                m = &member(count);
+            }
+            new (m) value_type(String(key.data(), key.size(), get_allocator()), Value());
+            ++count;
+            if (!slots.empty() && (size_t)count * 2 <= slots.size()) place(count - 1);
+            else if (count > HASH_MIN) rehash(std::bit_ceil((size_t)count * 4));
+            return m->second;
+        }
+
+        void grow() {
+            ArenaAllocator<value_type> alloc(get_allocator());
+            if (!more) more = ArenaAllocator<value_type*>(alloc).allocate(MAX_BLOCKS);
+            more[blocks] = alloc.allocate((size_t)first_cap << blocks);
+            ++blocks;
+        }
+
+        void place(size_t i) {
+            size_t mask = slots.size() - 1;
+            size_t h = std::hash<std::string_view>{}(std::string_view(member(i).first)) & mask;
+            while (slots[h] != 0) h = (h + 1) & mask;
+            slots[h] = (uint32_t)(i + 1);
+        }
+
+        void rehash(size_t cap) {
+            slots.assign(cap, 0);
+            for (size_t i = 0; i < count; ++i) place(i);
+        }
+    };
+
+    using ObjectType = FlatObject<class json>;
+    using ArrayType = std::vector<class json, ArenaAllocator<class json>>;
 
-    class Context {
+    // A parser fixed to one Mode: its indexing, validation and cursors are
+    // specialized at compile time. `Context` is the Mode::Standard one.
+    // Containers and strings materialized from its results live in the
+    // document's arena: they stay valid until the next parse_view() /
+    // begin_stream() or the Context's destruction; copy a value to keep it.
+    template<Mode M>
+    class BasicContext {
     public:
+        static constexpr Mode mode = M;
         std::shared_ptr<Document> doc;
-        Context() : doc(std::make_shared<Document>()) {}
+        BasicContext() : doc(std::make_shared<Document>()) { doc->arena_nodes = true; }
+        BasicContext(BasicContext&&) noexcept = default;
+        BasicContext& operator=(BasicContext&& o) noexcept {
+            if (this != &o) { close(); doc = std::move(o.doc); }
+            return *this;
+        }
+        ~BasicContext() { close(); }
         class json parse_view(const char* data, size_t len);
+
+        // Streaming: begin_stream(), append() each network chunk, then finish()
+        void begin_stream(size_t size_hint = 0) { doc->template begin_stream<M>(size_hint); }
+        void append(const char* data, size_t len) { doc->template append<M>(data, len); }
+        class json finish();
+
+        // After a rejected parse: offset, line and column of the first error
+        ParseError error() const { return doc->error(); }
+
+    private:
+        // Nodes still lazy when the Context goes materialize to the heap. With
+        // doc->borrow_nodes none may be left unless the document is shared.
+        void close() noexcept {
+            if (!doc) return;
+            doc->arena_nodes = false;
+            // Written arena containers end with the Context. Destroying them now
+            // drops the holds on the document that copied-in lazy nodes took.
+            doc->arena.run_cleanups();
+            if constexpr (TACHYON_CHECK_BORROWS) {
+                if (doc->borrow_nodes && doc.use_count() == 1 && doc->borrowed_refs.load() != 0) {
+                    std::fputs("Tachyon: borrowed json node outlives its Context\n", stderr);
+                    std::abort();
+                }
+            }
+        }
     };
 
+    using Context = BasicContext<Mode::Standard>;
+
+    // -------------------------------------------------------------------------
+    // JSON VALUE
+    // -------------------------------------------------------------------------
+    // A 16-byte tagged cell, so a materialized array of numbers costs 16 bytes
+    // per element. `meta` holds the Kind in its low byte, flags in the next and
+    // above them a string's length, or a lazy node's parse generation (one
+    // byte) and offset (documents up to 1 TiB). Strings of up to
+    // INLINE bytes are stored in the cell itself, from byte 2 on, with their
+    // length in the flags byte. Longer strings and containers are pointers,
+    // into the document's arena when IN_ARENA. Arena memory is never freed by
+    // a cell: a container handed out for writing (non-const operator[])
+    // registers its destructor with the arena instead (CLEANUP), so values
+    // stored into it are released at the next reset.
     class json {
-        std::variant<std::monostate, bool, int64_t, uint64_t, double, std::string, ObjectType, ArrayType, LazyNode> value;
+        enum Kind : uint8_t { Null, Bool, Int, UInt, Double, ShortString, LongString, Object, Array, Lazy };
+        static constexpr uint64_t IN_ARENA = 1;  // LongString / Object / Array: allocated from a Document's arena
+        static constexpr uint64_t OWNING = 2;    // Lazy: holds a reference on its document
+        static constexpr uint64_t CLEANUP = 4;   // Object / Array in an arena: destroyed by the arena's reset
+        static constexpr uint64_t BORROWED = 8;  // Lazy: holds nothing, its Context keeps the document (Document::borrow_nodes)
+        static constexpr size_t INLINE = 14;
+
+        uint64_t meta = Null;
+        union {
+            bool b;
+            int64_t i;
+            uint64_t u;
+            double d;
+            const char* str;
+            ObjectType* obj;
+            ArrayType* arr;
+            Document* doc;
+        } value{};
+
+        template<Mode> friend class BasicContext;
+
+        Kind kind() const { return (Kind)(meta & 0xFF); }
+        uint64_t flags() const { return (meta >> 8) & 0xFF; }
+        size_t aux() const { return (size_t)(meta >> 16); }
+        size_t lazy_offset() const { return (size_t)(meta >> 24); }
+        const char* inline_chars() const { return reinterpret_cast<const char*>(this) + 2; }
+
+        std::string_view string_ref() const {
+            if (kind() == ShortString) return std::string_view(inline_chars(), flags());
+            return std::string_view(value.str, aux());
+        }
+
+        // Inline when it fits, else a copy in `arena` (heap when null)
+        void assign_string(std::string_view s, Arena* arena) {
+            if (s.size() <= INLINE) {
+                meta = ShortString | (uint64_t)s.size() << 8;
+                value.u = 0;
+                std::memcpy(reinterpret_cast<char*>(this) + 2, s.data(), s.size());
+                return;
+            }
+            char* p = arena ? static_cast<char*>(arena->allocate(s.size(), 1)) : new char[s.size()];
+            std::memcpy(p, s.data(), s.size());
+            adopt_string(p, s.size(), arena);
+        }
+
+        void adopt_string(const char* p, size_t n, Arena* arena) {
+            meta = LongString | (arena ? IN_ARENA : 0) << 8 | (uint64_t)n << 16;
+            value.str = p;
+        }
+
+        // Lazy node `offset` bytes into `d`'s source. Members of the document's
+        // own arena containers (member = true) need no hold on it: they cannot
+        // outlive it. Other nodes are borrowed when the document allows it and
+        // hold a reference otherwise.
+        // The root of a parsed document; throws if a validating parse rejected it
+        template<Mode M>
+        static json root(Document* d) {
+            if (d->template validates<M>() && d->error_offset != Document::npos) throw ParseException(d->error());
+            return lazy(d, 0);
+        }
+
+        static json lazy(Document* d, size_t offset, bool member = false) {
+            json j;
+            j.meta = Lazy | (uint64_t)(d->generation & 0xFF) << 16 | (uint64_t)offset << 24;
+            j.value.doc = d;
+            if (!member) j.link();
+            return j;
+        }
+
+        // Borrowing is a plain copy: only checking builds count borrowed nodes
+        void link() {
+            Document* d = value.doc;
+            if (d->borrow_nodes) {
+                meta |= BORROWED << 8;
+                if constexpr (TACHYON_CHECK_BORROWS) d->borrowed_refs.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                meta |= OWNING << 8;
+                d->retain();
+            }
+        }
+
+        void unlink() {
+            if (flags() & OWNING) value.doc->release();
+            else if (TACHYON_CHECK_BORROWS && (flags() & BORROWED)) value.doc->borrowed_refs.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        // A lazy node's document. Checking builds reject nodes from an earlier parse.
+        Document* lazy_doc() const {
+            if constexpr (TACHYON_CHECK_BORROWS) {
+                if (TACHYON_UNLIKELY(((meta >> 16) & 0xFF) != (value.doc->generation & 0xFF))) {
+                    throw std::logic_error("Tachyon: lazy node used after its document was parsed again");
+                }
+            }
+            return value.doc;
+        }
+
+        template<typename C>
+        static C* make_container(Arena* arena) {
+            ArenaAllocator<char> alloc(arena);
+            if (arena) return new (arena->allocate(sizeof(C), alignof(C))) C(alloc);
+            return new C(alloc);
+        }
+
+        // Before a member of an arena container can be written, the container's
+        // destructor is registered with the arena (once)
+        void make_writable() {
+            if ((flags() & (IN_ARENA | CLEANUP)) != IN_ARENA) return;
+            meta |= CLEANUP << 8;
+            if (kind() == Object) value.obj->get_allocator().arena->on_reset([](void* p) { static_cast<ObjectType*>(p)->~ObjectType(); }, value.obj);
+            else value.arr->get_allocator().arena->on_reset([](void* p) { static_cast<ArrayType*>(p)->~ArrayType(); }, value.arr);
+        }
+
+        void destroy() {
+            switch (kind()) {
+                case LongString: if (!(flags() & IN_ARENA)) delete[] value.str; break;
+                case Object: if (!(flags() & IN_ARENA)) delete value.obj; break;
+                case Array: if (!(flags() & IN_ARENA)) delete value.arr; break;
+                case Lazy: unlink(); break;
+                default: break;
+            }
+        }
+
+        void swap(json& o) noexcept { std::swap(meta, o.meta); std::swap(value, o.value); }
+
+        // Appends to a buffer known to be large enough (unescaping never grows a string)
+        struct RawWriter {
+            char* p;
+            void reserve(size_t) {}
+            RawWriter& operator+=(char c) { *p++ = c; return *this; }
+        };
 
         // Internal Helpers
-        static void encode_utf8(std::string& res, uint32_t cp) {
+        // Runs `f` with a cursor over the document's tape when one was built, else over
+        // the bitmask. Documents of 4 GiB and up get the 64-bit offset variants, and
+        // only documents whose mode lets comments through get the comment checks.
+        template<typename F>
+        static decltype(auto) with_cursor(Document* d, size_t offset, const char* base, F&& f) {
+            if (d->cursor_comments) return with_cursor<true>(d, offset, base, f);
+            return with_cursor<false>(d, offset, base, f);
+        }
+
+        template<bool Comments, typename F>
+        static decltype(auto) with_cursor(Document* d, size_t offset, const char* base, F&& f) {
+            if (TACHYON_UNLIKELY(d->wide_offsets())) {
+                if (d->has_tape) { BasicCursor<true, uint64_t, Comments> c(d, offset, base); return f(c); }
+                BasicCursor<false, uint64_t, Comments> c(d, offset, base);
+                return f(c);
+            }
+            if (d->has_tape) { BasicCursor<true, uint32_t, Comments> c(d, offset, base); return f(c); }
+            BasicCursor<false, uint32_t, Comments> c(d, offset, base);
+            return f(c);
+        }
+
+        template<typename S>
+        static void encode_utf8(S& res, uint32_t cp) {
             if (cp <= 0x7F) res += (char)cp;
             else if (cp <= 0x7FF) { res += (char)(0xC0 | (cp >> 6)); res += (char)(0x80 | (cp & 0x3F)); }
             else if (cp <= 0xFFFF) { res += (char)(0xE0 | (cp >> 12)); res += (char)(0x80 | ((cp >> 6) & 0x3F)); res += (char)(0x80 | (cp & 0x3F)); }
@@ -694,6 +4082,12 @@ namespace Tachyon {
 
         static std::string unescape_string(std::string_view sv) {
             std::string res;
+            unescape_into(res, sv);
+            return res;
+        }
+
+        template<typename S>
+        static void unescape_into(S& res, std::string_view sv) {
             res.reserve(sv.size());
             for (size_t i = 0; i < sv.size(); ++i) {
                 if (sv[i] == '\\') {
@@ -732,10 +4126,9 @@ namespace Tachyon {
                     res += sv[i];
                 }
             }
-            return res;
         }
 
-        static std::string escape_string(const std::string& s) {
+        static std::string escape_string(std::string_view s) {
             std::string res = "\"";
             res.reserve(s.size() + 4);
             for (char c : s) {
@@ -763,22 +4156,40 @@ namespace Tachyon {
         }
 
     public:
-        json() : value(std::monostate{}) {}
-        json(std::nullptr_t) : value(std::monostate{}) {}
-        json(bool b) : value(b) {}
-        json(int i) : value(static_cast<int64_t>(i)) {}
-        json(int64_t i) : value(i) {}
-        json(uint64_t i) : value(i) {}
-        json(double d) : value(d) {}
-        json(const std::string& s) : value(s) {}
-        json(std::string&& s) : value(std::move(s)) {}
-        json(const char* s) : value(std::string(s)) {}
-        json(const ObjectType& o) : value(o) {}
-        json(const ArrayType& a) : value(a) {}
-        json(LazyNode l) : value(l) {}
+        json() = default;
+        json(std::nullptr_t) {}
+        json(bool b) : meta(Bool) { value.b = b; }
+        json(int i) : meta(Int) { value.i = i; }
+        json(int64_t i) : meta(Int) { value.i = i; }
+        json(uint64_t i) : meta(UInt) { value.u = i; }
+        json(double d) : meta(Double) { value.d = d; }
+        json(const std::string& s) { assign_string(s, nullptr); }
+        json(std::string_view s) { assign_string(s, nullptr); }
+        json(const char* s) { assign_string(s, nullptr); }
+        json(const ObjectType& o) : meta(Object) { value.obj = new ObjectType(o); }
+        json(const ArrayType& a) : meta(Array) { value.arr = new ArrayType(a); }
+
+        // Copies are deep and on the heap; copies of lazy nodes take their own hold
+        json(const json& o) : meta(o.meta), value(o.value) {
+            switch (o.kind()) {
+                case LongString: assign_string(o.string_ref(), nullptr); break;
+                case Object: meta = Object; value.obj = new ObjectType(*o.value.obj); break;
+                case Array: meta = Array; value.arr = new ArrayType(*o.value.arr); break;
+                case Lazy:
+                    meta &= ~((OWNING | BORROWED) << 8);
+                    if (o.flags() & OWNING) { meta |= OWNING << 8; value.doc->retain(); }
+                    else link();
+                    break;
+                default: break;
+            }
+        }
+        json(json&& o) noexcept : meta(o.meta), value(o.value) { o.meta = Null; }
+        json& operator=(const json& o) { json t(o); swap(t); return *this; }
+        json& operator=(json&& o) noexcept { json t(std::move(o)); swap(t); return *this; }
+        ~json() { if (kind() >= LongString) destroy(); }
 
         template<typename T, typename = std::enable_if_t<
-            !std::is_same_v<T, json> && !std::is_same_v<T, std::string> && !std::is_same_v<T, const char*> &&
+            !std::is_same_v<T, json> && !std::is_same_v<T, std::string> && !std::is_same_v<T, std::string_view> && !std::is_same_v<T, const char*> &&
             !std::is_arithmetic_v<T> && !std::is_null_pointer_v<T>>>
         json(const T& t) { to_json(*this, t); }
 
@@ -786,80 +4197,108 @@ namespace Tachyon {
         static json array() { return json(ArrayType{}); }
 
         // PARSING ENTRY POINTS
+        // Input a validating mode rejects throws ParseException with the offset,
+        // line and column of the first error.
+        template<Mode M = Mode::Standard>
         static json parse_view(const char* ptr, size_t len) {
-            auto doc = std::make_shared<Document>();
-            doc->parse_view(ptr, len);
-            return json(LazyNode{doc, 0, ptr});
+            return parse_view<M>(std::make_shared<Document>(), ptr, len);
+        }
+
+        template<Mode M = Mode::Standard>
+        static json parse_view(std::shared_ptr<Document> doc, const char* ptr, size_t len) {
+            doc->template parse_view<M>(ptr, len);
+            return root<M>(doc.get());
         }
 
+        template<Mode M = Mode::Standard>
         static json parse(std::string s) {
             auto doc = std::make_shared<Document>();
-            doc->parse(std::move(s));
-            return json(LazyNode{doc, 0, doc->get_base()});
+            doc->template parse<M>(std::move(s));
+            return root<M>(doc.get());
         }
 
         // ACCESSORS
-        bool is_null() const { return std::holds_alternative<std::monostate>(value) || (is_lazy() && lazy_char() == 'n'); }
-        bool is_array() const { return std::holds_alternative<ArrayType>(value) || (is_lazy() && lazy_char() == '['); }
-        bool is_object() const { return std::holds_alternative<ObjectType>(value) || (is_lazy() && lazy_char() == '{'); }
-        bool is_string() const { return std::holds_alternative<std::string>(value) || (is_lazy() && lazy_char() == '"'); }
-        bool is_lazy() const { return std::holds_alternative<LazyNode>(value); }
+        bool is_null() const { return kind() == Null || (is_lazy() && lazy_char() == 'n'); }
+        bool is_array() const { return kind() == Array || (is_lazy() && lazy_char() == '['); }
+        bool is_object() const { return kind() == Object || (is_lazy() && lazy_char() == '{'); }
+        bool is_string() const { return kind() == ShortString || kind() == LongString || (is_lazy() && lazy_char() == '"'); }
+        bool is_lazy() const { return kind() == Lazy; }
 
         char lazy_char() const {
-            const auto& l = std::get<LazyNode>(value);
-            const char* s = ASM::skip_whitespace(l.base_ptr + l.offset, l.base_ptr + l.doc->len);
-            if (s >= l.base_ptr + l.doc->len) return '\0';
+            const Document* d = lazy_doc();
+            const char* s = ASM::skip_whitespace(d->source + lazy_offset(), d->source + d->len);
+            if (s >= d->source + d->len) return '\0';
             return *s;
         }
 
-        template<typename T> void get_to(T& t) const {
+        template<typename T> void get_to(T& t) const& {
             if constexpr (std::is_same_v<T, int>) t = (int)as_int64();
             else if constexpr (std::is_same_v<T, int64_t>) t = as_int64();
             else if constexpr (std::is_same_v<T, double>) t = as_double();
             else if constexpr (std::is_same_v<T, bool>) t = as_bool();
             else if constexpr (std::is_same_v<T, std::string>) t = as_string();
+            else if constexpr (std::is_same_v<T, std::string_view>) t = as_string_view();
             else from_json(*this, t);
         }
-        template<typename T> T get() const { T t; get_to(t); return t; }
+        template<typename T> void get_to(T& t) const&& {
+            static_assert(!std::is_same_v<T, std::string_view>, "Tachyon: take a string_view from a named json (see as_string_view)");
+            get_to(t);
+        }
+        template<typename T> T get() const& { T t; get_to(t); return t; }
+        template<typename T> T get() const&& {
+            static_assert(!std::is_same_v<T, std::string_view>, "Tachyon: take a string_view from a named json (see as_string_view)");
+            T t; get_to(t); return t;
+        }
 
-        json& operator[](const std::string& key) {
+        json& operator[](std::string_view key) {
              materialize();
-             if (!std::holds_alternative<ObjectType>(value)) {
-                 if (std::holds_alternative<std::monostate>(value)) value = ObjectType{};
+             if (kind() != Object) {
+                 if (kind() == Null) *this = object();
                  else throw std::runtime_error("Tachyon: Type mismatch");
              }
-             return std::get<ObjectType>(value)[key];
+             make_writable();
+             return (*value.obj)[key];
         }
 
         json& operator[](size_t idx) {
              materialize();
-             if (!std::holds_alternative<ArrayType>(value)) {
-                 if (std::holds_alternative<std::monostate>(value)) value = ArrayType{};
+             if (kind() != Array) {
+                 if (kind() == Null) *this = array();
                  else throw std::runtime_error("Tachyon: Type mismatch");
              }
-             ArrayType& arr = std::get<ArrayType>(value);
+             make_writable();
+             ArrayType& arr = *value.arr;
              if (idx >= arr.size()) arr.resize(idx + 1);
              return arr[idx];
         }
 
-        const json operator[](const std::string& key) const {
+        const json operator[](std::string_view key) const {
             if (is_lazy()) return lazy_lookup(key);
-            if (std::holds_alternative<ObjectType>(value)) {
-                const auto& o = std::get<ObjectType>(value);
+            if (kind() == Object) {
+                const ObjectType& o = *value.obj;
                 auto it = o.find(key);
                 if (it != o.end()) return it->second;
             }
             return json();
         }
 
-        const json at(const std::string& key) const {
+        const json operator[](size_t idx) const {
+            if (is_lazy()) return lazy_index(idx);
+            if (kind() == Array) {
+                const ArrayType& a = *value.arr;
+                if (idx < a.size()) return a[idx];
+            }
+            return json();
+        }
+
+        const json at(std::string_view key) const {
              if (is_lazy()) {
                  json res = lazy_lookup(key);
                  if (res.is_null()) throw std::out_of_range("Key not found");
                  return res;
              }
-             if (!std::holds_alternative<ObjectType>(value)) throw std::runtime_error("Not object");
-             const auto& o = std::get<ObjectType>(value);
+             if (kind() != Object) throw std::runtime_error("Not object");
+             const ObjectType& o = *value.obj;
              auto it = o.find(key);
              if (it == o.end()) throw std::out_of_range("Key not found");
              return it->second;
@@ -867,82 +4306,106 @@ namespace Tachyon {
 
         std::string as_string() const {
             if (is_lazy()) {
-                const auto& l = std::get<LazyNode>(value);
-                const char* s = ASM::skip_whitespace(l.base_ptr + l.offset, l.base_ptr + l.doc->len);
+                Document* d = lazy_doc();
+                const char* base = d->source;
+                const char* s = ASM::skip_whitespace(base + lazy_offset(), base + d->len);
                 if (*s != '"') return "";
-                uint32_t start = (uint32_t)(s - l.base_ptr);
-                Cursor c(l.doc.get(), start + 1, l.base_ptr);
-                uint32_t end = c.next_fast();
-                std::string_view sv(l.base_ptr + start + 1, end - start - 1);
+                size_t start = (size_t)(s - base);
+                size_t end = with_cursor(d, start + 1, base, [](auto& c) -> size_t { return c.next_fast(); });
+                std::string_view sv(base + start + 1, end - start - 1);
+                if (sv.find('\\') == std::string_view::npos) return std::string(sv);
                 return unescape_string(sv);
             }
-            if (std::holds_alternative<std::string>(value)) return std::get<std::string>(value);
+            if (kind() == ShortString || kind() == LongString) return std::string(string_ref());
             return "";
         }
 
+        // The string without a copy when it holds no escapes: a view into the
+        // source. An escaped string is unescaped into the document's arena on
+        // its first read and served from there afterwards (Document::unescaped,
+        // safe from several threads). Valid until the document's next parse (a
+        // materialized string: while this value is unchanged). Empty if not a string.
+        // A materialized string's bytes belong to this value, so a temporary
+        // (the const operator[] returns copies) cannot be viewed: name it first.
+        std::string_view as_string_view() const&& = delete;
+        std::string_view as_string_view() const& {
+            if (is_lazy()) {
+                Document* d = lazy_doc();
+                const char* base = d->source;
+                const char* s = ASM::skip_whitespace(base + lazy_offset(), base + d->len);
+                if (*s != '"') return std::string_view();
+                size_t start = (size_t)(s - base);
+                size_t end = with_cursor(d, start + 1, base, [](auto& c) -> size_t { return c.next_fast(); });
+                std::string_view sv(base + start + 1, end - start - 1);
+                if (sv.find('\\') == std::string_view::npos) return sv;
+                return d->unescaped(start, sv, [](char* p, std::string_view raw) {
+                    RawWriter w{p};
+                    unescape_into(w, raw);
+                    return (size_t)(w.p - p);
+                });
+            }
+            if (kind() == ShortString || kind() == LongString) return string_ref();
+            return std::string_view();
+        }
+
         int64_t as_int64() const {
              if (is_lazy()) {
-                const auto& l = std::get<LazyNode>(value);
-                const char* s = ASM::skip_whitespace(l.base_ptr + l.offset, l.base_ptr + l.doc->len);
-                int64_t i = 0; std::from_chars(s, l.base_ptr + l.doc->len, i); return i;
+                const Document* d = lazy_doc();
+                const char* s = ASM::skip_whitespace(d->source + lazy_offset(), d->source + d->len);
+                int64_t i = 0; std::from_chars(s, d->source + d->len, i); return i;
              }
-             if (std::holds_alternative<int64_t>(value)) return std::get<int64_t>(value);
-             if (std::holds_alternative<double>(value)) return (int64_t)std::get<double>(value);
+             if (kind() == Int) return value.i;
+             if (kind() == Double) return (int64_t)value.d;
              return 0;
         }
 
         double as_double() const {
              if (is_lazy()) {
-                const auto& l = std::get<LazyNode>(value);
-                const char* s = ASM::skip_whitespace(l.base_ptr + l.offset, l.base_ptr + l.doc->len);
-                double d = 0.0; std::from_chars(s, l.base_ptr + l.doc->len, d, std::chars_format::general); return d;
+                const Document* d = lazy_doc();
+                const char* s = ASM::skip_whitespace(d->source + lazy_offset(), d->source + d->len);
+                double v = 0.0; std::from_chars(s, d->source + d->len, v, std::chars_format::general); return v;
              }
-             if (std::holds_alternative<double>(value)) return std::get<double>(value);
-             if (std::holds_alternative<int64_t>(value)) return (double)std::get<int64_t>(value);
+             if (kind() == Double) return value.d;
+             if (kind() == Int) return (double)value.i;
              return 0.0;
         }
 
         bool as_bool() const {
              if (is_lazy()) return lazy_char() == 't';
-             if (std::holds_alternative<bool>(value)) return std::get<bool>(value);
+             if (kind() == Bool) return value.b;
              return false;
         }
 
-        bool contains(const std::string& key) const {
+        bool contains(std::string_view key) const {
             if (is_lazy()) return !lazy_lookup(key).is_null();
-            if (is_object()) {
-                const auto& o = std::get<ObjectType>(value);
-                return o.find(key) != o.end();
-            }
+            if (kind() == Object) return value.obj->contains(key);
             return false;
         }
 
         size_t size() const {
              if (is_lazy()) return lazy_size();
-             if (std::holds_alternative<ArrayType>(value)) return std::get<ArrayType>(value).size();
-             if (std::holds_alternative<ObjectType>(value)) return std::get<ObjectType>(value).size();
+             if (kind() == Array) return value.arr->size();
+             if (kind() == Object) return value.obj->size();
              return 0;
         }
 
         std::string dump() const {
             if (is_lazy()) { json c = *this; c.materialize(); return c.dump(); }
-            if (std::holds_alternative<std::string>(value)) return escape_string(std::get<std::string>(value));
-            if (std::holds_alternative<int64_t>(value)) return std::to_string(std::get<int64_t>(value));
-            if (std::holds_alternative<bool>(value)) return std::get<bool>(value) ? "true" : "false";
-            if (std::holds_alternative<std::monostate>(value)) return "null";
-            if (std::holds_alternative<ObjectType>(value)) {
+            if (kind() == ShortString || kind() == LongString) return escape_string(string_ref());
+            if (kind() == Int) return std::to_string(value.i);
+            if (kind() == Bool) return value.b ? "true" : "false";
+            if (kind() == Null) return "null";
+            if (kind() == Object) {
                 std::string s = "{";
-                const auto& o = std::get<ObjectType>(value);
                 bool f = true;
-                for (const auto& [k, v] : o) { if (!f) s += ","; f = false; s += escape_string(k) + ":" + v.dump(); }
+                for (const auto& [k, v] : *value.obj) { if (!f) s += ","; f = false; s += escape_string(k) + ":" + v.dump(); }
                 s += "}";
                 return s;
             }
-            if (std::holds_alternative<ArrayType>(value)) {
+            if (kind() == Array) {
                 std::string s = "[";
-                const auto& a = std::get<ArrayType>(value);
                 bool f = true;
-                for (const auto& v : a) { if (!f) s += ","; f = false; s += v.dump(); }
+                for (const auto& v : *value.arr) { if (!f) s += ","; f = false; s += v.dump(); }
                 s += "]";
                 return s;
             }
@@ -952,360 +4415,236 @@ namespace Tachyon {
     private:
         void materialize() {
              if (!is_lazy()) return;
-             const auto& l = std::get<LazyNode>(value);
-             const char* base = l.base_ptr;
-             const char* s = ASM::skip_whitespace(base + l.offset, base + l.doc->len);
+             Document* d = lazy_doc();
+             const char* base = d->source;
+             const char* s = ASM::skip_whitespace(base + lazy_offset(), base + d->len);
              char c = *s;
+             // Nodes of a Context's document go to its arena, valid until its next
+             // parse; the lazy members of arena containers hold nothing on it
+             Arena* arena = d->arena_nodes ? &d->arena : nullptr;
+             json out;
              if (c == '{') {
-                ObjectType obj;
-                uint32_t start = (uint32_t)(s - base) + 1;
-                Cursor cur(l.doc.get(), start, base);
-                while (true) {
-                    uint32_t curr = cur.next();
-                    if (curr == (uint32_t)-1 || base[curr] == '}') break;
-                    if (base[curr] == ',') continue;
-                    if (base[curr] == '"') {
-                        uint32_t end_q = cur.next();
-                        std::string_view ksv(base + curr + 1, end_q - curr - 1);
-                        std::string k = unescape_string(ksv);
-                        uint32_t colon = cur.next();
-                        const char* vs = ASM::skip_whitespace(base + colon + 1, base + l.doc->len);
-                        json child(LazyNode{l.doc, (uint32_t)(vs - base), base});
-                        char vc = *vs;
-                        if (vc == '{') skip_container(cur, base, '{', '}');
-                        else if (vc == '[') skip_container(cur, base, '[', ']');
-                        else if (vc == '"') { cur.next(); cur.next(); }
-                        obj[std::move(k)] = std::move(child);
+                ObjectType* obj = make_container<ObjectType>(arena);
+                out.meta = Object | (arena ? IN_ARENA : 0) << 8;
+                out.value.obj = obj;
+                size_t start = (size_t)(s - base) + 1;
+                obj->reserve(member_count_hint(d, base, start));
+                with_cursor(d, start, base, [&](auto& cur) {
+                    while (true) {
+                        auto curr = cur.next();
+                        if (curr == cur.npos || base[curr] == '}') break;
+                        if (base[curr] == ',') continue;
+                        if (base[curr] == '"') {
+                            auto end_q = cur.next();
+                            std::string_view ksv(base + curr + 1, end_q - curr - 1);
+                            String k(ArenaAllocator<char>{arena});
+                            if (ksv.find('\\') != std::string_view::npos) {
+                                unescape_into(k, ksv);
+                                ksv = k;
+                            }
+                            cur.next(); // ':'
+                            auto v = cur.next();
+                            if (v == cur.npos) break;
+                            (*obj)[ksv] = lazy(d, (size_t)v, arena != nullptr);
+                            skip_value(cur, base, v);
+                        }
                     }
-                }
-                value = std::move(obj);
+                });
             } else if (c == '[') {
-                 ArrayType arr;
-                 uint32_t start = (uint32_t)(s - base) + 1;
-                 Cursor cur(l.doc.get(), start, base);
-                 const char* p = s + 1;
-                 while (true) {
-                     p = ASM::skip_whitespace(p, base + l.doc->len);
-                     if (*p == ']') break;
-                     arr.push_back(json(LazyNode{l.doc, (uint32_t)(p - base), base}));
-                     char ch = *p;
-                     uint32_t next_delim;
-                     if (ch == '{') { skip_container(cur, base, '{', '}'); next_delim = cur.next(); }
-                     else if (ch == '[') { skip_container(cur, base, '[', ']'); next_delim = cur.next(); }
-                     else if (ch == '"') { cur.next(); cur.next(); next_delim = cur.next(); }
-                     else { next_delim = cur.next(); }
-                     if (next_delim == (uint32_t)-1 || base[next_delim] == ']') break;
-                     p = base + next_delim + 1;
-                 }
-                 value = std::move(arr);
-            } else if (c == '"') { value = as_string(); }
-            else if (c == 't') { value = true; }
-            else if (c == 'f') { value = false; }
-            else if (c == 'n') { value = std::monostate{}; }
-            else {
-                // Heuristic: check for float indicators in next few chars
-                bool is_float = false;
-                for(int k=0; k<32; ++k) {
-                    char ck = s[k];
-                    if (ck == ',' || ck == '}' || ck == ']' || ck == '\0') break;
-                    if (ck == '.' || ck == 'e' || ck == 'E') { is_float = true; break; }
+                 ArrayType* arr = make_container<ArrayType>(arena);
+                 out.meta = Array | (arena ? IN_ARENA : 0) << 8;
+                 out.value.arr = arr;
+                 size_t start = (size_t)(s - base) + 1;
+                 arr->reserve(member_count_hint(d, base, start));
+                 with_cursor(d, start, base, [&](auto& cur) {
+                     // Every value start is a token: no whitespace rescans between elements
+                     auto v = cur.next();
+                     while (v != cur.npos && base[v] != ']') {
+                         arr->push_back(lazy(d, (size_t)v, arena != nullptr));
+                         skip_value(cur, base, v);
+                         auto next_delim = cur.next();
+                         if (next_delim == cur.npos || base[next_delim] != ',') break;
+                         v = cur.next();
+                     }
+                 });
+            } else if (c == '"') {
+                size_t start = (size_t)(s - base);
+                size_t end = with_cursor(d, start + 1, base, [](auto& cur) -> size_t { return cur.next_fast(); });
+                std::string_view raw(base + start + 1, end - start - 1);
+                if (raw.find('\\') == std::string_view::npos) {
+                    out.assign_string(raw, arena);
+                } else if (raw.size() <= INLINE) {
+                    // Unescaping never lengthens: a raw string that fits inline stays inline
+                    char buf[16];
+                    RawWriter w{buf};
+                    unescape_into(w, raw);
+                    out.assign_string(std::string_view(buf, (size_t)(w.p - buf)), nullptr);
+                } else {
+                    char* p = arena ? static_cast<char*>(arena->allocate(raw.size(), 1)) : new char[raw.size()];
+                    RawWriter w{p};
+                    unescape_into(w, raw);
+                    out.adopt_string(p, (size_t)(w.p - p), arena);
                 }
-                if (is_float) value = as_double();
-                else value = as_int64();
             }
+            else if (c == 't') { out = true; }
+            else if (c == 'f') { out = false; }
+            else if (c == 'n') { }
+            else {
+                // A number spans up to the next token; it is a float iff it holds '.', 'e' or 'E'
+                size_t num = (size_t)(s - base);
+                size_t end = with_cursor(d, num + 1, base, [](auto& c) -> size_t { return c.next_fast(); });
+                end = std::min(end, d->len);
+                bool is_float = d->has_types ? d->span_has_float(num, end)
+                                             : std::any_of(s, base + end, [](char ck) { return ck == '.' || ck == 'e' || ck == 'E'; });
+                if (is_float) out = as_double();
+                else out = as_int64();
+            }
+            // The members have their own holds by now: this node's goes with `node`
+            json node;
+            node.meta = meta;
+            node.value = value;
+            meta = out.meta;
+            value = out.value;
+            out.meta = Null;
         }
 
-        json lazy_lookup(const std::string& key) const {
-            const auto& l = std::get<LazyNode>(value);
-            const char* base = l.base_ptr;
-            const char* s = ASM::skip_whitespace(base + l.offset, base + l.doc->len);
-            if (*s != '{') return json();
-            uint32_t start = (uint32_t)(s - base) + 1;
-            Cursor c(l.doc.get(), start, base);
-
-            // Apex / Turbo Path: Use Direct-Key-Jump
-            uint32_t key_pos = c.find_key(key.data(), key.size());
-            if (key_pos == (uint32_t)-1) return json();
-
-            // find_key returns the index of the closing quote of the key.
-            // We need to move past the colon.
-            uint32_t colon = c.next_fast(); // Should be the colon
-            if (base[colon] != ':') return json(); // Should not happen
+        // Members of the container opening at `start` - 1 as counted by one SIMD
+        // depth scan (commas + 1; may be one too many for an empty container), so
+        // materializing allocates once. 0 when the scan does not apply.
+        static size_t member_count_hint(const Document* d, const char* base, size_t start) {
+            if (d->has_tape || !d->fully_indexed()) return 0;
+            SIMD::DepthScan r = SIMD::scan_depth<true>(base, d->len, d->bitmask.get(), d->bitmask_len, start, 1);
+            return r.close == SIMD::DepthScan::npos ? 0 : r.commas + 1;
+        }
 
-            const char* vs = ASM::skip_whitespace(base + colon + 1, base + l.doc->len);
-            return json(LazyNode{l.doc, (uint32_t)(vs - base), base});
+        json lazy_lookup(std::string_view key) const {
+            Document* d = lazy_doc();
+            const char* base = d->source;
+            const char* s = ASM::skip_whitespace(base + lazy_offset(), base + d->len);
+            if (*s != '{') return json();
+            size_t start = (size_t)(s - base) + 1;
+            return with_cursor(d, start, base, [&](auto& c) -> json {
+                // Apex / Turbo Path: Use Direct-Key-Jump
+                auto key_pos = c.find_key(key.data(), key.size());
+                if (key_pos == c.npos) return json();
+
+                // find_key returns the index of the closing quote of the key.
+                // We need to move past the colon.
+                auto colon = c.next_fast(); // Should be the colon
+                if (colon == c.npos || base[colon] != ':') return json(); // Should not happen
+
+                // The value's first byte is itself indexed
+                auto v = c.next_fast();
+                if (v == c.npos) return json();
+                return lazy(d, (size_t)v);
+            });
         }
 
         json lazy_index(size_t idx) const {
-            const auto& l = std::get<LazyNode>(value);
-            const char* base = l.base_ptr;
-            const char* s = ASM::skip_whitespace(base + l.offset, base + l.doc->len);
+            Document* d = lazy_doc();
+            const char* base = d->source;
+            const char* s = ASM::skip_whitespace(base + lazy_offset(), base + d->len);
             if (*s != '[') return json();
-            uint32_t start = (uint32_t)(s - base) + 1;
-            Cursor c(l.doc.get(), start, base);
-            size_t count = 0;
-            const char* p = s + 1;
-            while (true) {
-                p = ASM::skip_whitespace(p, base + l.doc->len);
-                if (*p == ']') return json();
-                if (count == idx) return json(LazyNode{l.doc, (uint32_t)(p - base), base});
-                char ch = *p;
-                uint32_t next_delim;
-                if (ch == '{') { skip_container(c, base, '{', '}'); next_delim = c.next(); }
-                else if (ch == '[') { skip_container(c, base, '[', ']'); next_delim = c.next(); }
-                else if (ch == '"') { c.next(); c.next(); next_delim = c.next(); }
-                else { next_delim = c.next(); }
-                count++;
-                if (next_delim == (uint32_t)-1 || base[next_delim] == ']') return json();
-                p = base + next_delim + 1;
+            size_t start = (size_t)(s - base) + 1;
+            if (d->has_tree) {
+                const TreeIndex& t = d->tree;
+                size_t v = t.slot_value(t.node_at(start - 1), idx);
+                if (v == TreeIndex::npos) return json();
+                if (base[v] != '/') return lazy(d, v);  // A comment first: walk instead
             }
+            return with_cursor(d, start, base, [&](auto& c) -> json {
+                size_t count = 0;
+                auto v = c.next();
+                while (v != c.npos && base[v] != ']') {
+                    if (count == idx) return lazy(d, (size_t)v);
+                    skip_value(c, base, v);
+                    count++;
+                    auto next_delim = c.next();
+                    if (next_delim == c.npos || base[next_delim] != ',') break;
+                    v = c.next();
+                }
+                return json();
+            });
         }
 
         // HYBRID DUAL-PATH lazy_size
         size_t lazy_size() const {
-            const auto& l = std::get<LazyNode>(value);
-            const char* base = l.base_ptr;
-            const char* s = ASM::skip_whitespace(base + l.offset, base + l.doc->len);
+            Document* d = lazy_doc();
+            const char* base = d->source;
+            const char* s = ASM::skip_whitespace(base + lazy_offset(), base + d->len);
             if (*s != '[') return 0;
-            uint32_t start_off = (uint32_t)(s - base) + 1;
-            const uint32_t* bitmask = l.doc->bitmask.get();
-            size_t max_block = l.doc->bitmask_len;
-            size_t count = 0;
-            int depth = 1;
-            const char* first_element = s + 1;
-            uint32_t block_idx = start_off / 32;
-            uint32_t initial_mask = bitmask[block_idx];
-            initial_mask &= ~((1U << (start_off % 32)) - 1);
-
-            auto check_end = [&](uint32_t curr_off) {
-                if (count > 0) return count + 1;
-                if (ASM::skip_whitespace(first_element, base + curr_off) < base + curr_off) return (size_t)1;
-                return (size_t)0;
-            };
-
-            auto run_avx2 = [&](uint32_t mask) __attribute__((target("avx2"))) -> size_t {
-                const __m256i v_comma = _mm256_set1_epi8(',');
-                const __m256i v_lbra = _mm256_set1_epi8('[');
-                const __m256i v_rbra = _mm256_set1_epi8(']');
-                const __m256i v_lcur = _mm256_set1_epi8('{');
-                const __m256i v_rcur = _mm256_set1_epi8('}');
-
-                while(true) {
-                    while (mask == 0) {
-                        block_idx++;
-                        if (block_idx >= max_block) return 0;
-                        mask = bitmask[block_idx];
-                    }
-                    __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(base + block_idx * 32));
-                    uint32_t m_comma = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, v_comma));
-                    uint32_t m_open = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, v_lbra), _mm256_cmpeq_epi8(chunk, v_lcur)));
-                    uint32_t m_close = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, v_rbra), _mm256_cmpeq_epi8(chunk, v_rcur)));
-
-                    if (depth == 1 && ((m_open | m_close) & mask) == 0) {
-                        count += std::popcount(m_comma & mask);
-                    }
-                    else if (depth > 1 && (m_close & mask) == 0) {
-                        depth += std::popcount(m_open & mask);
-                        block_idx++;
-                        if (block_idx >= max_block) break;
-                        mask = bitmask[block_idx];
-                        continue;
-                    }
-                    else {
-                        uint32_t m_iter = mask;
-                        while (m_iter != 0) {
-                            int bit = std::countr_zero(m_iter);
-                            uint32_t bit_mask = (1U << bit);
-                            m_iter &= (m_iter - 1);
-
-                            bool is_comma = (m_comma & bit_mask) != 0;
-                            bool is_close = (m_close & bit_mask) != 0;
-                            bool is_open  = (m_open & bit_mask) != 0;
-
-                            if (is_comma) {
-                                if (depth == 1) count++;
-                            } else if (is_close) {
-                                depth--;
-                                if (depth == 0) return check_end(block_idx * 32 + bit);
-                            } else if (is_open) {
-                                depth++;
-                            }
-                        }
-                    }
-                    block_idx++;
-                    if (block_idx >= max_block) break;
-                    mask = bitmask[block_idx];
-                }
-                return count;
-            };
-
-            auto run_avx512 = [&](uint32_t mask32) __attribute__((target("avx512f,avx512bw"))) -> size_t {
-                const __m512i v_comma = _mm512_set1_epi8(',');
-                const __m512i v_lbra = _mm512_set1_epi8('[');
-                const __m512i v_rbra = _mm512_set1_epi8(']');
-                const __m512i v_lcur = _mm512_set1_epi8('{');
-                const __m512i v_rcur = _mm512_set1_epi8('}');
-
-                // First 32-byte block handling
-                {
-                    __m512i chunk = _mm512_castsi256_si512(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(base + block_idx * 32)));
-                    uint64_t m_comma = _mm512_cmpeq_epi8_mask(chunk, v_comma);
-                    uint64_t m_open = _mm512_cmpeq_epi8_mask(chunk, v_lbra) | _mm512_cmpeq_epi8_mask(chunk, v_lcur);
-                    uint64_t m_close = _mm512_cmpeq_epi8_mask(chunk, v_rbra) | _mm512_cmpeq_epi8_mask(chunk, v_rcur);
-
-                    uint64_t m64 = mask32;
-                    m_comma &= 0xFFFFFFFF; m_open &= 0xFFFFFFFF; m_close &= 0xFFFFFFFF;
-
-                    if (depth == 1 && ((m_open | m_close) & m64) == 0) {
-                        count += std::popcount(m_comma & m64);
-                    } else {
-                        uint64_t m_iter = m64;
-                        while (m_iter != 0) {
-                            int bit = std::countr_zero(m_iter);
-                            uint64_t bit_mask = (1ULL << bit);
-                            m_iter &= (m_iter - 1);
-
-                            bool is_comma = (m_comma & bit_mask) != 0;
-                            bool is_close = (m_close & bit_mask) != 0;
-                            bool is_open  = (m_open & bit_mask) != 0;
-
-                            if (is_comma) {
-                                if (depth == 1) count++;
-                            } else if (is_close) {
-                                depth--;
-                                if (depth == 0) return check_end(block_idx * 32 + bit);
-                            } else if (is_open) {
-                                depth++;
-                            }
-                        }
-                    }
-                    block_idx++;
-                }
-
-                // Main Loop (64-byte chunks)
-                while(true) {
-                    if (block_idx + 1 >= max_block) break;
-                    uint64_t mask64 = (uint64_t)bitmask[block_idx] | ((uint64_t)bitmask[block_idx+1] << 32);
-
-                    while (mask64 == 0) {
-                        block_idx += 2;
-                        if (block_idx + 1 >= max_block) return 0;
-                        mask64 = (uint64_t)bitmask[block_idx] | ((uint64_t)bitmask[block_idx+1] << 32);
-                    }
-
-                    _mm_prefetch(base + block_idx * 32 + 1024, _MM_HINT_T0);
-
-                    __m512i chunk = _mm512_loadu_si512(reinterpret_cast<const __m512i*>(base + block_idx * 32));
-                    uint64_t m_comma = _mm512_cmpeq_epi8_mask(chunk, v_comma);
-                    uint64_t m_open = _mm512_cmpeq_epi8_mask(chunk, v_lbra) | _mm512_cmpeq_epi8_mask(chunk, v_lcur);
-                    uint64_t m_close = _mm512_cmpeq_epi8_mask(chunk, v_rbra) | _mm512_cmpeq_epi8_mask(chunk, v_rcur);
-
-                    if (depth == 1 && ((m_open | m_close) & mask64) == 0) {
-                        count += std::popcount(m_comma & mask64);
-                    }
-                    else if (depth > 1 && (m_close & mask64) == 0) {
-                        depth += std::popcount(m_open & mask64);
-                        block_idx += 2;
-                        continue;
-                    }
-                    else {
-                        uint64_t m_iter = mask64;
-                        while (m_iter != 0) {
-                            int bit = std::countr_zero(m_iter);
-                            uint64_t bit_mask = (1ULL << bit);
-                            m_iter &= (m_iter - 1);
-
-                            bool is_comma = (m_comma & bit_mask) != 0;
-                            bool is_close = (m_close & bit_mask) != 0;
-                            bool is_open  = (m_open & bit_mask) != 0;
-
-                            if (is_comma) {
-                                if (depth == 1) count++;
-                            } else if (is_close) {
-                                depth--;
-                                if (depth == 0) { _mm256_zeroupper(); return check_end(block_idx * 32 + bit); }
-                            } else if (is_open) {
-                                depth++;
-                            }
-                        }
-                    }
-                    block_idx += 2;
-                }
-
-                // Tail
-                if (block_idx < max_block) {
-                    uint32_t mask32 = bitmask[block_idx];
-                    __m512i chunk = _mm512_castsi256_si512(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(base + block_idx * 32)));
-                    uint64_t m_comma = _mm512_cmpeq_epi8_mask(chunk, v_comma);
-                    uint64_t m_open = _mm512_cmpeq_epi8_mask(chunk, v_lbra) | _mm512_cmpeq_epi8_mask(chunk, v_lcur);
-                    uint64_t m_close = _mm512_cmpeq_epi8_mask(chunk, v_rbra) | _mm512_cmpeq_epi8_mask(chunk, v_rcur);
-
-                    uint64_t m64 = mask32;
-                    m_comma &= 0xFFFFFFFF; m_open &= 0xFFFFFFFF; m_close &= 0xFFFFFFFF;
-
-                    if (((m_open | m_close) & m64) == 0) {
-                        if (depth == 1) count += std::popcount(m_comma & m64);
-                    } else {
-                        uint64_t m_iter = m64;
-                        while (m_iter != 0) {
-                            int bit = std::countr_zero(m_iter);
-                            uint64_t bit_mask = (1ULL << bit);
-                            m_iter &= (m_iter - 1);
-
-                            bool is_comma = (m_comma & bit_mask) != 0;
-                            bool is_close = (m_close & bit_mask) != 0;
-                            bool is_open  = (m_open & bit_mask) != 0;
-
-                            if (is_comma) {
-                                if (depth == 1) count++;
-                            } else if (is_close) {
-                                depth--;
-                                if (depth == 0) { _mm256_zeroupper(); return check_end(block_idx * 32 + bit); }
-                            } else if (is_open) {
-                                depth++;
-                            }
-                        }
-                    }
+            size_t start_off = (size_t)(s - base) + 1;
+            if (d->has_tree) return d->tree.slot_count(d->tree.node_at(start_off - 1));
+            if (!d->has_tape && d->fully_indexed()) {
+                SIMD::DepthScan r = SIMD::scan_depth<true>(base, d->len, d->bitmask.get(), d->bitmask_len, start_off, 1);
+                if (r.close != SIMD::DepthScan::npos) {
+                    if (r.commas > 0) return r.commas + 1;
+                    // Every value start is indexed: with no commas, the array holds one
+                    // element iff its first token is not the closing bracket
+                    size_t first = with_cursor(d, start_off, base, [](auto& c) -> size_t { return c.next_fast(); });
+                    return first < r.close ? 1 : 0;
                 }
-
-                _mm256_zeroupper();
-                return count;
-            };
-
-            if (g_active_isa == ISA::AVX512) return run_avx512(initial_mask);
-            return run_avx2(initial_mask);
+            }
+            return with_cursor(d, start_off, base, [&](auto& c) { return lazy_size_scan(c, base); });
         }
 
-        void skip_container(Cursor& c, const char* base, char open, char close) const {
-            int depth = 0;
+        // Token path (tape, documents indexed on demand, JSONC comments): one character test per structural token
+        template<typename C>
+        static size_t lazy_size_scan(C& c, const char* base) {
+            size_t count = 0;
+            int depth = 1;
+            auto first = c.npos;
             while (true) {
-                uint32_t curr = c.next();
-                if (curr == (uint32_t)-1) break;
+                auto curr = c.next();
+                if (curr == c.npos) return 0;
+                if (first == c.npos) first = curr;
                 char ch = base[curr];
-                if (ch == open) depth++;
-                else if (ch == close) depth--;
-                else if (ch == '"') c.next();
-                if (depth == 0) break;
+                if (ch == ',') { if (depth == 1) count++; }
+                else if (ch == '[' || ch == '{') { if (!c.jump_past_match(curr)) depth++; }
+                else if (ch == ']' || ch == '}') {
+                    if (--depth == 0) {
+                        if (count > 0) return count + 1;
+                        return curr != first ? 1 : 0;
+                    }
+                }
             }
         }
 
-        void skip_container_fast(Cursor& c, const char* base, char open, char close) const {
-            int depth = 0;
-            while (true) {
-                uint32_t curr = c.next_fast();
-                if (curr == (uint32_t)-1) break;
-                char ch = base[curr];
-                if (ch == open) depth++;
-                else if (ch == close) depth--;
-                else if (ch == '"') c.next_fast();
-                if (depth == 0) break;
+        // Consumes the rest of a value whose first token `first` was just read:
+        // the closing quote of a string or everything up to the matching bracket.
+        // Scalars are a single token.
+        template<typename C>
+        static void skip_value(C& c, const char* base, typename C::offset_type first) {
+            char ch = base[first];
+            if (ch == '"') { c.next(); return; }
+            if (ch != '{' && ch != '[') return;
+            if (c.jump_past_match(first)) return;
+            int depth = 1;
+            while (depth) {
+                auto curr = c.next();
+                if (curr == c.npos) break;
+                char t = base[curr];
+                if (t == '{' || t == '[') depth++;
+                else if (t == '}' || t == ']') depth--;
+                else if (t == '"') c.next();
             }
         }
     };
 
-    inline json Context::parse_view(const char* data, size_t len) {
-        doc->parse_view(data, len);
-        return json(LazyNode{doc, 0, data});
+    static_assert(sizeof(json) == 16, "json is a 16-byte cell");
+
+    template<Mode M>
+    inline json BasicContext<M>::parse_view(const char* data, size_t len) {
+        doc->template parse_view<M>(data, len);
+        if (doc->template validates<M>() && doc->error_offset != Document::npos) return json();
+        return json::lazy(doc.get(), 0);
+    }
+
+    template<Mode M>
+    inline json BasicContext<M>::finish() {
+        doc->template finish_stream<M>();
+        if (doc->template validates<M>() && doc->error_offset != Document::npos) return json();
+        return json::lazy(doc.get(), 0);
     }
 
 } // namespace Tachyon
@@ -0,0 +1,664 @@
+// Tachyon unit tests: `make test`, or standalone with
+//   g++ -std=c++20 -O2 -march=native -I. tests/unit_tests.cpp -o tests/unit_tests
+#include "include_Tachyon_0.7.2v/Tachyon.hpp"
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Tachyon;
+
+static int g_failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { std::printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); g_failures++; } \
+} while (0)
+
+static const ISA ALL_ISAS[] = { ISA::Scalar, ISA::SSE42, ISA::AVX2, ISA::AVX512 };
+
+// Every tier the host supports (set_isa never raises a kernel above it)
+static std::vector<ISA> host_isas() {
+    std::vector<ISA> out;
+    for (ISA isa : ALL_ISAS) {
+        set_isa(isa);
+        if (get_isa(Kernel::Index) == isa) out.push_back(isa);
+    }
+    set_isa(ISA::AVX512);
+    return out;
+}
+
+// Deterministic random input: `noise` draws bytes mostly from `alphabet`
+// (quotes, escapes, structurals); `value` builds valid JSON.
+struct Random {
+    std::mt19937_64 rng;
+    explicit Random(uint64_t seed) : rng(seed) {}
+
+    size_t below(size_t n) { return (size_t)(rng() % n); }
+
+    std::string noise(size_t n, const char* alphabet) {
+        size_t k = std::strlen(alphabet);
+        std::string s(n, ' ');
+        for (char& c : s) c = below(3) ? alphabet[below(k)] : "xyz 0"[below(5)];
+        return s;
+    }
+
+    std::string string() {
+        static const char* const parts[] = { "\\\"", "\\\\", "\\n", "\\u00e9", "{", "]", ",", ":", "//", "/*", "\xc3\xa9" };
+        std::string s = "\"";
+        for (size_t n = below(12); n--;) {
+            if (below(2)) s += parts[below(std::size(parts))];
+            else s += (char)('a' + below(26));
+        }
+        return s + "\"";
+    }
+
+    std::string number() {
+        switch (below(4)) {
+            case 0: return std::to_string(rng() % 100000);
+            case 1: return std::string("-").append(std::to_string(rng() % 1000));
+            case 2: return std::to_string(rng() % 100) + "." + std::to_string(rng() % 100);
+            default: return std::to_string(1 + rng() % 9) + "e-" + std::to_string(rng() % 5);
+        }
+    }
+
+    std::string ws() { return std::string(below(3), " \n\t"[below(3)]); }
+
+    std::string value(int depth = 0) {
+        switch (below(depth > 5 ? 4 : 6)) {
+            case 0: return string();
+            case 1: return number();
+            case 2: return below(2) ? "true" : "false";
+            case 3: return "null";
+            case 4: {
+                std::string v = "{";
+                for (size_t i = 0, n = below(6); i < n; ++i) {
+                    if (i) v += ",";
+                    v += ws() + "\"k" + std::to_string(i) + "\"" + ws() + ":" + ws() + value(depth + 1) + ws();
+                }
+                return v + "}";
+            }
+            default: {
+                std::string v = "[";
+                for (size_t i = 0, n = below(7); i < n; ++i) {
+                    if (i) v += ",";
+                    v += ws() + value(depth + 1) + ws();
+                }
+                return v + "]";
+            }
+        }
+    }
+};
+
+static bool titan_accepts(const std::string& s) {
+    BasicContext<Mode::Titan> ctx;
+    ctx.doc->jsonc = true;
+    ctx.parse_view(s.data(), s.size());
+    return !ctx.error();
+}
+
+// ---------------------------------------------------------------------------
+// JSONC: comment openers across the 64-byte word boundary
+// ---------------------------------------------------------------------------
+// `pad` spaces after '[' put the "1" at byte pad + 1 and the '/' at pad + 2,
+// so pad 61 places a lone '/' on bit 63 and "//" or "/*" across two words.
+static void test_jsonc_word_boundary() {
+    for (ISA isa : host_isas()) {
+        set_isa(isa);
+        for (size_t pad = 58; pad < 66; ++pad) {
+            std::string head = std::string("[").append(pad, ' ') + "1";
+            CHECK(!titan_accepts(head + "/]"));
+            CHECK(titan_accepts(head + "//x\n]"));
+            CHECK(titan_accepts(head + "/*x*/]"));
+            CHECK(titan_accepts(head + "/**/]"));
+
+            Context ctx;
+            ctx.doc->jsonc = true;
+            std::string s = head + "//]\n,2]";
+            CHECK(ctx.parse_view(s.data(), s.size()).dump() == "[1,2]");
+        }
+        // The same across an on-demand window and a validation window
+        for (size_t w = Document::ON_DEMAND_WINDOW - 66; w < Document::ON_DEMAND_WINDOW - 60; ++w) {
+            std::string s = std::string("[").append(w, ' ') + "1//x\n,2]";
+            Context ctx;
+            ctx.doc->jsonc = true;
+            ctx.doc->index_on_demand = true;
+            CHECK(ctx.parse_view(s.data(), s.size()).dump() == "[1,2]");
+            CHECK(titan_accepts(s));
+        }
+    }
+    set_isa(ISA::AVX512);
+}
+
+// ---------------------------------------------------------------------------
+// Document reference count: nodes taken and dropped on several threads
+// ---------------------------------------------------------------------------
+// Members of a written (arena) container hold nothing, so every copy of one
+// raises the count from zero and every drop returns it there.
+static void test_node_refs_threads() {
+    std::string s = R"({"a":[1,2,3],"b":{"c":"a string longer than inline"},"d":[4]})";
+    for (int rep = 0; rep < 8; ++rep) {
+        Context ctx;
+        json root = ctx.parse_view(s.data(), s.size());
+        root["d"] = 5;
+        const json& view = root;
+        CHECK(ctx.doc->node_refs.load() == 0);
+
+        std::vector<std::thread> threads;
+        std::atomic<int> wrong{0};
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < 5000; ++i) {
+                    json a = view["a"];
+                    json b = view["b"];
+                    if (a.size() != 3 || !b.is_object()) wrong++;
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+        CHECK(wrong.load() == 0);
+        CHECK(ctx.doc->node_refs.load() == 0 && !ctx.doc->self);
+
+        // A node that outlives its Context keeps the document alive
+        json kept = view["b"];
+        ctx = Context();
+        CHECK(kept["c"].as_string() == "a string longer than inline");
+    }
+}
+
+// ---------------------------------------------------------------------------
+// as_string_view(): escaped strings are unescaped once per parse
+// ---------------------------------------------------------------------------
+static void test_string_view_escapes() {
+    std::string s = R"(["plain", "tab\there \u00e9", "quote \"q\" and more text"])";
+    Context ctx;
+    const json doc = ctx.parse_view(s.data(), s.size());
+    const json plain = doc[0];
+    CHECK(plain.as_string_view() == "plain");
+    CHECK(plain.as_string_view().data() == s.data() + 2);
+
+    const json escaped = doc[1];
+    std::string_view first = escaped.as_string_view();
+    CHECK(first == "tab\there \xc3\xa9");
+    CHECK(first == escaped.as_string());
+    for (int i = 0; i < 1000; ++i) {
+        const json again = doc[1];
+        CHECK(again.as_string_view().data() == first.data());
+    }
+
+    std::vector<std::thread> threads;
+    std::atomic<int> wrong{0};
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 2000; ++i) {
+                const json q = doc[2];
+                if (q.as_string_view() != "quote \"q\" and more text") wrong++;
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    CHECK(wrong.load() == 0);
+}
+
+// A written string's bytes live in its json: views come from named values,
+// and temporaries (the const operator[] returns copies) are rejected
+template <typename J> concept ViewableRvalue = requires(const J& j) { std::move(j).as_string_view(); };
+static_assert(!ViewableRvalue<json>);
+
+static void test_string_view_written() {
+    std::string s = R"({"lazy":"in the source"})";
+    Context ctx;
+    json obj = ctx.parse_view(s.data(), s.size());
+    obj["short"] = "abc";
+    obj["long"] = "a string longer than inline";
+    const json& cobj = obj;
+
+    const json short_copy = cobj["short"], long_copy = cobj["long"], lazy = cobj["lazy"];
+    std::string_view views[] = { short_copy.as_string_view(), long_copy.as_string_view(), lazy.as_string_view(),
+                                 obj["short"].as_string_view(), short_copy.get<std::string_view>() };
+    obj["more"] = std::string(100, 'x');
+    CHECK(views[0] == "abc" && views[1] == "a string longer than inline" && views[2] == "in the source");
+    CHECK(views[3] == "abc" && views[4] == "abc");
+}
+
+// ---------------------------------------------------------------------------
+// Parallel indexing: chunk boundaries inside strings and backslash runs
+// ---------------------------------------------------------------------------
+// Exactly 2 MiB on two threads splits at PARALLEL_MIN_CHUNK. `probe` is
+// placed `before` bytes ahead of that boundary, between filler members that
+// carry float markers.
+static std::string parallel_doc(const std::string& probe, size_t before) {
+    const size_t boundary = Document::PARALLEL_MIN_CHUNK;
+    std::string s = "[";
+    while (s.size() + 16 < boundary - before) s += "\"ab\",1.5e3,-2, ";
+    s.append(boundary - before - s.size(), ' ');
+    s += probe + ",";
+    while (s.size() + 16 < 2 * boundary - 2) s += "\"ab\",1.5e3,-2, ";
+    s.append(2 * boundary - 2 - s.size(), ' ');
+    return s + "0]";
+}
+
+static void test_parallel_index_matches() {
+    Document single, parallel;
+    single.build_types = parallel.build_types = true;
+    parallel.index_threads = 2;
+    std::vector<std::string> probes = { std::string("\"").append(40, 's') + "\"" };
+    for (size_t run = 1; run <= 4; ++run) {
+        probes.push_back(std::string("\"").append(run, '\\') + (run % 2 ? "\"" : "") + "tail\"");
+    }
+    for (ISA isa : host_isas()) {
+        set_isa(isa);
+        for (const std::string& probe : probes) {
+            for (size_t before = 1; before < probe.size(); ++before) {
+                std::string s = parallel_doc(probe, before);
+                single.parse_view(s.data(), s.size());
+                parallel.parse_view(s.data(), s.size());
+                CHECK(single.bitmask_len == parallel.bitmask_len);
+                size_t words = std::min(single.bitmask_len, parallel.bitmask_len);
+                CHECK(std::memcmp(single.bitmask.get(), parallel.bitmask.get(), words * sizeof(uint64_t)) == 0);
+                CHECK(std::memcmp(single.float_bitmask.get(), parallel.float_bitmask.get(), words * sizeof(uint64_t)) == 0);
+            }
+        }
+    }
+    set_isa(ISA::AVX512);
+}
+
+// ---------------------------------------------------------------------------
+// Dispatch: TACHYON_ISA / TACHYON_ISA_<KERNEL>
+// ---------------------------------------------------------------------------
+static void test_dispatch_env() {
+    setenv("TACHYON_ISA", "scalar", 1);
+    setenv("TACHYON_ISA_INDEX", "avx9", 1);  // Unknown: keeps the global choice
+    {
+        Dispatch d;
+        CHECK(d.get(Kernel::Index) == ISA::Scalar);
+        CHECK(d.get(Kernel::Lines) == ISA::Scalar);
+    }
+    unsetenv("TACHYON_ISA");
+    setenv("TACHYON_ISA_INDEX", "bogus", 1);
+    setenv("TACHYON_ISA_LINES", "scalar", 1);
+    {
+        Dispatch d;
+        CHECK(d.get(Kernel::Index) == d.detected);
+        CHECK(d.get(Kernel::Whitespace) == d.detected);
+        CHECK(d.get(Kernel::Lines) == ISA::Scalar);
+    }
+    unsetenv("TACHYON_ISA_INDEX");
+    unsetenv("TACHYON_ISA_LINES");
+}
+
+// ---------------------------------------------------------------------------
+// Escape resolution: every engine against a byte-by-byte reference
+// ---------------------------------------------------------------------------
+// A quote is a token unless an odd run of backslashes precedes it, runs
+// crossing 64-byte words included. Every engine must also index exactly
+// what the portable one does.
+static void test_escape_resolution() {
+    Random r(1);
+    for (int it = 0; it < 3000; ++it) {
+        std::string s = r.noise(r.below(700), "\\\\\\\\\"\"{}:,");
+        size_t words = s.size() / 64 + 2;
+        std::vector<uint64_t> quotes(words), tokens(words);
+        size_t run = 0;
+        for (size_t i = 0; i < s.size(); ++i) {
+            if (s[i] == '"') {
+                quotes[i / 64] |= 1ULL << (i % 64);
+                if (run % 2 == 0) tokens[i / 64] |= 1ULL << (i % 64);
+            }
+            run = s[i] == '\\' ? run + 1 : 0;
+        }
+
+        std::vector<uint64_t> ref(words);
+        SIMD::IndexState ref_state;
+        SIMD::select_structural_mask(ISA::Scalar)(s.data(), s.size(), ref.data(), ref_state, nullptr, nullptr);
+        for (ISA isa : host_isas()) {
+            std::vector<uint64_t> m(words);
+            SIMD::IndexState state;
+            SIMD::select_structural_mask(isa)(s.data(), s.size(), m.data(), state, nullptr, nullptr);
+            CHECK(m == ref);
+            for (size_t w = 0; w < words; ++w) CHECK((m[w] & quotes[w]) == tokens[w]);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Stage 1: every vector engine against the portable one
+// ---------------------------------------------------------------------------
+// The prefix XOR is taken by carry-less multiply where the host has it and by
+// shifts otherwise, and AVX-512 classifies by VBMI or by nibble tables; all
+// must index exactly what the portable engine does, plain and JSONC, including
+// the alternate (entered-inside-a-string) and float masks, in one call and
+// resumed at 64- and 128-byte splits with the carried state.
+static void test_engines_match_scalar() {
+    Random r(2);
+    const bool host_clmul = g_dispatch.clmul, host_vbmi = g_dispatch.vbmi;
+    for (int it = 0; it < 3000; ++it) {
+        std::string s = r.noise(r.below(700), "\"\"\\\\//**\n{}[]:, \t.eE1-");
+        size_t words = s.size() / 64 + 2;
+        for (bool jsonc : { false, true }) {
+            std::vector<uint64_t> ref(words), ref_alt(words), ref_float(words);
+            SIMD::IndexState ref_state;
+            SIMD::select_structural_mask(ISA::Scalar, jsonc)(s.data(), s.size(), ref.data(), ref_state, ref_alt.data(), ref_float.data());
+
+            for (ISA isa : host_isas()) {
+                for (int variant = 0; variant < 3; ++variant) {
+                    g_dispatch.clmul = variant != 1 && host_clmul;
+                    g_dispatch.vbmi = variant != 2 && host_vbmi;
+                    SIMD::MaskFunction fn = SIMD::select_structural_mask(isa, jsonc);
+                    g_dispatch.clmul = host_clmul;
+                    g_dispatch.vbmi = host_vbmi;
+
+                    std::vector<uint64_t> m(words), alt(words), fl(words);
+                    SIMD::IndexState state;
+                    fn(s.data(), s.size(), m.data(), state, alt.data(), fl.data());
+                    CHECK(m == ref && alt == ref_alt && fl == ref_float);
+                    CHECK(state.in_string == ref_state.in_string && state.prev_escaped == ref_state.prev_escaped);
+                    CHECK(state.comment == ref_state.comment && state.comment_edge == ref_state.comment_edge);
+
+                    size_t split = r.below(s.size() / 64 + 1) * 64;
+                    if (it % 2) split &= ~(size_t)127;
+                    std::vector<uint64_t> m2(words), alt2(words), fl2(words);
+                    SIMD::IndexState resumed;
+                    fn(s.data(), split, m2.data(), resumed, alt2.data(), fl2.data());
+                    fn(s.data() + split, s.size() - split, m2.data() + split / 64, resumed, alt2.data() + split / 64, fl2.data() + split / 64);
+                    CHECK(m2 == ref && alt2 == ref_alt && fl2 == ref_float);
+                }
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Optional indexes: every one reads the same document as a plain parse
+// ---------------------------------------------------------------------------
+static void test_index_variants_match() {
+    Random r(4);
+    for (int it = 0; it < 300; ++it) {
+        std::string s = r.ws() + r.value() + r.ws();
+        Context plain;
+        std::string ref = plain.parse_view(s.data(), s.size()).dump();
+
+        Context tape;
+        tape.doc->build_tape = true;
+        CHECK(tape.parse_view(s.data(), s.size()).dump() == ref);
+
+        Context on_demand;
+        on_demand.doc->index_on_demand = true;
+        CHECK(on_demand.parse_view(s.data(), s.size()).dump() == ref);
+
+        Context jumps;
+        jumps.doc->build_jumps = true;
+        CHECK(jumps.parse_view(s.data(), s.size()).dump() == ref);
+
+        Context tree;
+        tree.doc->build_tree = true;
+        CHECK(tree.parse_view(s.data(), s.size()).dump() == ref);
+
+        Context borrowed;
+        borrowed.doc->borrow_nodes = true;
+        CHECK(borrowed.parse_view(s.data(), s.size()).dump() == ref);
+        CHECK(borrowed.doc->node_refs.load() == 0);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Streaming: chunked appends index exactly like one parse
+// ---------------------------------------------------------------------------
+template<Mode M>
+static void check_stream_matches(const std::string& s, Random& r, bool jsonc) {
+    BasicContext<M> once, streamed;
+    once.doc->jsonc = streamed.doc->jsonc = jsonc;
+    json a = once.parse_view(s.data(), s.size());
+    streamed.begin_stream(r.below(2) ? s.size() : 0);
+    for (size_t at = 0; at < s.size();) {
+        size_t n = std::min(s.size() - at, 1 + r.below(300));
+        streamed.append(s.data() + at, n);
+        at += n;
+    }
+    json b = streamed.finish();
+    CHECK(a.dump() == b.dump());
+    CHECK(!once.error() == !streamed.error());
+    CHECK(once.doc->bitmask_len == streamed.doc->bitmask_len);
+    if (once.doc->bitmask_len == streamed.doc->bitmask_len && !once.error()) {
+        CHECK(std::memcmp(once.doc->bitmask.get(), streamed.doc->bitmask.get(), once.doc->bitmask_len * sizeof(uint64_t)) == 0);
+    }
+}
+
+static void test_stream_matches_one_shot() {
+    Random r(3);
+    for (ISA isa : host_isas()) {
+        set_isa(isa);
+        for (int it = 0; it < 200; ++it) {
+            std::string s = r.ws() + r.value() + r.ws();
+            while (s.size() < 700) s = "[" + s + "," + r.value() + "]";
+            check_stream_matches<Mode::Standard>(s, r, false);
+            check_stream_matches<Mode::Titan>(s, r, false);
+
+            // Comments between tokens, including ones cut by an append
+            std::string c;
+            bool in_string = false, escaped = false;
+            for (char ch : s) {
+                c += ch;
+                if (in_string) {
+                    if (escaped) escaped = false;
+                    else if (ch == '\\') escaped = true;
+                    else if (ch == '"') in_string = false;
+                } else if (ch == '"') {
+                    in_string = true;
+                } else if (ch == ',' && r.below(3) == 0) {
+                    c += r.below(2) ? " /* ] , */ " : " // [ \"\n";
+                }
+            }
+            check_stream_matches<Mode::Standard>(c, r, true);
+        }
+    }
+    set_isa(ISA::AVX512);
+}
+
+// ---------------------------------------------------------------------------
+// UTF-8 validation: each sequence at every position around block edges
+// ---------------------------------------------------------------------------
+static void test_utf8_validation() {
+    const char* const valid[] = {
+        "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\xef\xbf\xbf", "\xf4\x8f\xbf\xbf", "\xed\x9f\xbf",
+    };
+    const char* const invalid[] = {
+        "\xc3", "\xe2\x82", "\xf0\x9f\x98", "\x80", "\xbf\xbf", "\xc0\xaf", "\xc1\xbf", "\xe0\x9f\xbf",
+        "\xf0\x8f\xbf\xbf", "\xed\xa0\x80", "\xf4\x90\x80\x80", "\xf5\x80\x80\x80", "\xff", "\xc3\xa9\xa9",
+    };
+    for (ISA isa : host_isas()) {
+        set_isa(isa);
+        for (size_t at = 0; at < 140; ++at) {
+            std::string pad(at, 'a');
+            for (const char* seq : valid) {
+                CHECK(ASM::validate_utf8((pad + seq + "tail").data(), at + std::strlen(seq) + 4));
+                CHECK(ASM::validate_utf8((pad + seq).data(), at + std::strlen(seq)));
+            }
+            for (const char* seq : invalid) {
+                CHECK(!ASM::validate_utf8((pad + seq + "tail").data(), at + std::strlen(seq) + 4));
+                CHECK(!ASM::validate_utf8((pad + seq).data(), at + std::strlen(seq)));
+            }
+        }
+    }
+    set_isa(ISA::AVX512);
+}
+
+// ---------------------------------------------------------------------------
+// Mode::Titan: valid / invalid corpus
+// ---------------------------------------------------------------------------
+static void test_titan_corpus() {
+    const char* const valid[] = {
+        "{}", "[]", "0", "-0", "-0.5e+10", "1E-2", "true", "null", "\"\"", " [ 1 , 2 ] ",
+        "{\"a\":{\"b\":[[],{}]},\"c\":\"\\u00e9\\n\\\"\"}",
+        "\"\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80\"",
+        "[\"\\ud83d\\ude00\", 123456789012345678901234567890]",
+        "\n\t{\"k\" : false}\r\n",
+    };
+    const char* const invalid[] = {
+        "", " ", "[1,]", "[,1]", "{\"a\"}", "{\"a\":}", "{\"a\" 1}", "{1:2}", "[1 2]", "[1}", "{]", "[[]",
+        "[]]", "01", "1.", ".5", "-", "1e", "+1", "tru", "nul", "True", "[1]x", "\"abc", "\"\\x\"",
+        "\"\\u12\"", "\"tab\there\"", "\"\xc3\"", "\"\xed\xa0\x80\"", "[1/]", "{\"a\":1,}", "'a'",
+    };
+    for (ISA isa : host_isas()) {
+        set_isa(isa);
+        for (const char* doc : valid) {
+            std::string s = doc;
+            BasicContext<Mode::Titan> titan;
+            titan.parse_view(s.data(), s.size());
+            CHECK(!titan.error());
+            Context checked;
+            checked.doc->validate = true;
+            checked.parse_view(s.data(), s.size());
+            CHECK(!checked.error());
+        }
+        for (const char* doc : invalid) {
+            std::string s = doc;
+            BasicContext<Mode::Titan> titan;
+            json j = titan.parse_view(s.data(), s.size());
+            CHECK(titan.error() && j.is_null());
+        }
+        // Valid random documents, and containers cut short
+        Random r(5);
+        for (int it = 0; it < 300; ++it) {
+            std::string s = r.ws() + r.value() + r.ws();
+            CHECK(titan_accepts(s));
+            size_t open = s.find_first_not_of(" \n\t");
+            if (s[open] == '[' || s[open] == '{') CHECK(!titan_accepts(s.substr(0, (open + s.find_last_of("]}")) / 2 + 1)));
+        }
+    }
+    set_isa(ISA::AVX512);
+}
+
+// The static entry points have no Context to ask: a rejected parse throws its
+// location, which stays readable after the input is gone
+template<typename Parse>
+static ParseError thrown_error(Parse parse) {
+    try {
+        parse();
+    } catch (const ParseException& e) {
+        CHECK(e.what() == e.error().message());
+        return e.error();
+    }
+    return ParseError();
+}
+
+static void test_static_parse_errors() {
+    struct Case { const char* doc; size_t offset, line, column; };
+    const Case cases[] = {
+        { "[1,]", 3, 1, 4 }, { "{\"a\":1,}", 7, 1, 8 }, { "{\"a\" 1}", 5, 1, 6 }, { "[1 2]", 3, 1, 4 },
+        { "[[]", 3, 1, 4 }, { "\"abc", 0, 1, 1 }, { "[\"\\x\"]", 2, 1, 3 }, { "[\"\xc3\"]", 2, 1, 3 },
+        { "{\n  \"a\": [1,\n    tru]\n}", 17, 3, 5 },
+    };
+    for (ISA isa : host_isas()) {
+        set_isa(isa);
+        for (const Case& c : cases) {
+            ParseError e = thrown_error([&] { json::parse<Mode::Titan>(c.doc); });
+            CHECK(e && e.offset() == c.offset && e.line() == c.line && e.column() == c.column);
+
+            std::string s = c.doc;
+            CHECK(thrown_error([&] { json::parse_view<Mode::Titan>(s.data(), s.size()); }).offset() == c.offset);
+            auto doc = std::make_shared<Document>();
+            doc->validate = true;
+            CHECK(thrown_error([&] { json::parse_view(doc, s.data(), s.size()); }).offset() == c.offset);
+        }
+    }
+    set_isa(ISA::AVX512);
+    CHECK(json::parse<Mode::Titan>("{\"a\":[1,2]}")["a"][1].as_int64() == 2);
+    CHECK(!thrown_error([] { json::parse("[1,]"); }));  // Not validated
+}
+
+// ---------------------------------------------------------------------------
+// Arena: cleanups run before the blocks they live in are freed
+// ---------------------------------------------------------------------------
+static int g_arena_destroyed = 0;
+
+static void test_arena_release() {
+    using Ints = std::vector<int>;
+    Arena arena;
+    for (int round = 0; round < 2; ++round) {
+        g_arena_destroyed = 0;
+        for (int i = 0; i < 3; ++i) {
+            Ints* v = new (arena.allocate(sizeof(Ints), alignof(Ints))) Ints(100, i);
+            arena.on_reset([](void* p) {
+                Ints* v = static_cast<Ints*>(p);
+                if (v->size() == 100) g_arena_destroyed++;
+                v->~Ints();
+            }, v);
+        }
+        arena.release();
+        CHECK(g_arena_destroyed == 3);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Context: written arena containers let go of the document with it
+// ---------------------------------------------------------------------------
+// A lazy node copied into a container of its own document holds that
+// document; the Context's end destroys the container and so the hold.
+static void test_written_nodes_free_document() {
+    std::string s = R"({"old":"a string longer than inline"})";
+    std::weak_ptr<Document> weak;
+    {
+        Context ctx;
+        weak = ctx.doc;
+        json j = ctx.parse_view(s.data(), s.size());
+        json v = j["old"];
+        j["new"] = v;
+        CHECK(j["new"].as_string() == "a string longer than inline");
+    }
+    CHECK(weak.expired());
+}
+
+// ---------------------------------------------------------------------------
+// Objects: references to members survive later inserts
+// ---------------------------------------------------------------------------
+static void test_object_member_refs() {
+    std::string s = R"({"old":"a string longer than inline","n":1})";
+    for (bool parsed : { false, true }) {
+        Context ctx;
+        json j = parsed ? ctx.parse_view(s.data(), s.size()) : json::object();
+        if (!parsed) { j["old"] = "a string longer than inline"; j["n"] = 1; }
+
+        // Enough inserts to regrow the member list and build the hash index
+        j["new"] = j["old"];
+        json& a = j["a"];
+        json& old = j["old"];
+        for (int i = 0; i < 100; ++i) j[std::string("k").append(std::to_string(i))] = j["old"];
+        a = 2;
+        CHECK(j["a"].get<int64_t>() == 2);
+        CHECK(old.as_string() == "a string longer than inline");
+        CHECK(j["new"].as_string() == "a string longer than inline");
+        CHECK(j["k99"].as_string() == "a string longer than inline");
+        CHECK(j.size() == 104);
+
+        json copy = j;
+        CHECK(copy.dump() == j.dump());
+    }
+}
+
+int main() {
+    test_escape_resolution();
+    test_dispatch_env();
+    test_jsonc_word_boundary();
+    test_node_refs_threads();
+    test_string_view_escapes();
+    test_string_view_written();
+    test_parallel_index_matches();
+    test_engines_match_scalar();
+    test_index_variants_match();
+    test_stream_matches_one_shot();
+    test_utf8_validation();
+    test_titan_corpus();
+    test_static_parse_errors();
+    test_arena_release();
+    test_written_nodes_free_document();
+    test_object_member_refs();
+    if (g_failures) {
+        std::printf("%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("All tests passed\n");
+    return 0;
+}